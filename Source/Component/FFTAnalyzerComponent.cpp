@@ -47,15 +47,42 @@ FFTAnalyzerComponent::FFTAnalyzerComponent(BiztortionAudioProcessor& p, unsigned
       rightPathProducer(*audioProcessor.rightAnalyzerFIFOs[0])
 {
     auto index = audioProcessor.getFftAnalyzerFifoIndexOfCorrespondingFilter(chainPosition);
-    leftPathProducer.setSingleChannelSampleFifo(audioProcessor.leftAnalyzerFIFOs[index]);
-    rightPathProducer.setSingleChannelSampleFifo(audioProcessor.rightAnalyzerFIFOs[index]);
+    leftFifo = audioProcessor.leftAnalyzerFIFOs[index];
+    rightFifo = audioProcessor.rightAnalyzerFIFOs[index];
+    leftPathProducer.setSingleChannelSampleFifo(leftFifo.get());
+    rightPathProducer.setSingleChannelSampleFifo(rightFifo.get());
 
     startTimerHz(59);
 }
 
+FFTAnalyzerComponent::~FFTAnalyzerComponent()
+{
+    stopTimer();
+    setTapsArmed(false);
+}
+
+void FFTAnalyzerComponent::setTapsArmed(bool shouldBeArmed)
+{
+    if (shouldBeArmed == tapsArmed)
+        return;
+
+    tapsArmed = shouldBeArmed;
+    if (tapsArmed) {
+        leftFifo->arm();
+        rightFifo->arm();
+    }
+    else {
+        leftFifo->disarm();
+        rightFifo->disarm();
+    }
+}
+
 void FFTAnalyzerComponent::timerCallback() {
 
-    if (enableFFTanalysis) {
+    // the taps follow the analyzer toggle and the editor visibility
+    setTapsArmed(enableFFTanalysis && isShowing());
+
+    if (tapsArmed) {
         auto fftBounds = getAnalysysArea().toFloat();
         auto sampleRate = audioProcessor.getSampleRate();
         leftPathProducer.process(fftBounds, sampleRate);
@@ -238,6 +265,7 @@ PathProducer& FFTAnalyzerComponent::getRightPathProducer()
 void FFTAnalyzerComponent::toggleFFTanaysis(bool shouldEnableFFTanalysis)
 {
     enableFFTanalysis = shouldEnableFFTanalysis;
+    setTapsArmed(enableFFTanalysis && isShowing());
 }
 
 juce::Rectangle<int> FFTAnalyzerComponent::getRenderArea()
@@ -48,6 +48,7 @@ struct FFTAnalyzerComponent : juce::Component,
     juce::Timer {
 
     FFTAnalyzerComponent(BiztortionAudioProcessor& p, unsigned int chainPosition);
+    ~FFTAnalyzerComponent();
 
     void timerCallback() override;
     void paint(juce::Graphics& g) override;
@@ -61,6 +62,11 @@ private:
     BiztortionAudioProcessor& audioProcessor;
     bool enableFFTanalysis = true;
 
+    // the audio thread feeds these FIFOs only while they are armed, i.e. while the analysis is enabled and showing
+    std::shared_ptr<SingleChannelSampleFifo<juce::AudioBuffer<float>>> leftFifo, rightFifo;
+    bool tapsArmed = false;
+    void setTapsArmed(bool shouldBeArmed);
+
     juce::Image background;
 
     // for the FFT analyzer
@@ -52,57 +52,15 @@ BitcrusherModuleDSP::BitcrusherModuleDSP(juce::AudioProcessorValueTreeState& _ap
 {
 }
 
-Array<float> BitcrusherModuleDSP::getWhiteNoise(int numSamples) {
-
-    Array<float> noise;
-
-    float z0 = 0;
-    float z1 = 0;
-    bool generate = false;
-
-    float mu = 0; // center (0)
-    float sigma = 1; // spread -1 <-> 1
-
-    float output = 0;
-    float u1 = 0;
-    float u2 = 0;
-
-    Random r = Random::getSystemRandom();
-    r.setSeed(Time::getCurrentTime().getMilliseconds());
-    const float epsilon = std::numeric_limits<float>::min();
-
-    for (int s = 0; s < numSamples; s++)
-    {
-        // box muller method
-        // https://en.wikipedia.org/wiki/Box%E2%80%93Muller_transform
-        generate = !generate;
-
-        if (!generate)
-            output = z1 * sigma + mu;
-        else
-        {
-            do
-            {
-                u1 = r.nextFloat();
-                u2 = r.nextFloat();
-            } while (u1 <= epsilon);
-
-            z0 = sqrtf(-2.0 * logf(u1)) * cosf(2 * float(double_Pi) * u2);
-            z1 = sqrtf(-2.0 * logf(u1)) * sinf(2 * float(double_Pi) * u2);
-
-            output = z0 * sigma + mu;
-        }
-
-        // NAN check
-        jassert(output == output);
-        jassert(output > -50 && output < 50);
-
-        noise.add(output);
+void BitcrusherModuleDSP::seedNoiseGenerators(bool useFixedSeed)
+{
+    auto seed = useFixedSeed ? static_cast<juce::uint64>(getChainPosition()) * 0x1000193ull
+        : static_cast<juce::uint64>(juce::Random::getSystemRandom().nextInt64());
 
+    for (size_t channel = 0; channel < noiseGenerators.size(); ++channel) {
+        // different seeds => decorrelated channels
+        noiseGenerators[channel].setSeed(seed + channel);
     }
-
-    return noise;
-
 }
 
 void BitcrusherModuleDSP::setModuleType()
@@ -112,9 +70,11 @@ void BitcrusherModuleDSP::setModuleType()
 
 void BitcrusherModuleDSP::updateDSPState(double sampleRate)
 {
-    auto settings = getSettings(apvts, getChainPosition());
+    auto settings = getSettings(parameterHandles);
 
     bypassed = settings.bypassed;
+    setBypassFadeTarget(bypassed);
+    stereoMode = static_cast<StereoMode>(settings.stereoMode);
 
     auto mix = settings.mix * 0.01f;
     dryGain.setTargetValue(1.f - mix);
@@ -124,16 +84,109 @@ void BitcrusherModuleDSP::updateDSPState(double sampleRate)
     bias.setTargetValue(settings.bias);
 
     rateRedux.setTargetValue(settings.rateRedux);
+    holdTailSamples = (int)std::ceil(getHoldRatio(settings.rateRedux, sampleRate));
     bitRedux.setTargetValue(settings.bitRedux);
     dither.setTargetValue(settings.dither * 0.01f);
+
+    // restart the reproducible sequence when the fixed seed gets enabled
+    if (settings.fixedSeed && !fixedSeed) {
+        seedNoiseGenerators(true);
+    }
+    fixedSeed = settings.fixedSeed;
+
+    // time/frequency domain switch (the STFT is cleared at every change)
+    auto spectral = settings.domain == 1;
+    auto order = SpectralBitcrusher::minOrder + settings.fftOrder;
+    if (spectral != spectralDomain || (spectral && order != spectralBitcrusher.getOrder())) {
+        spectralDomain = spectral;
+        if (spectral) {
+            spectralBitcrusher.setOrder(order);
+        }
+        const auto latency = spectral ? spectralBitcrusher.getLatencySamples() : 0;
+        if (latency != latencySamples) {
+            // the samples stored for the old latency would come out misaligned with the new STFT
+            latencySamples = latency;
+            dryDelay.reset();
+            tempDelay.reset();
+            dryDelay.setDelay((float)latencySamples);
+            tempDelay.setDelay((float)latencySamples);
+        }
+    }
 }
 
-void BitcrusherModuleDSP::prepareToPlay(double sampleRate, int samplesPerBlock)
+void BitcrusherModuleDSP::prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels)
 {
-    wetBuffer.setSize(2, samplesPerBlock, false, true, true); // clears
-    noiseBuffer.setSize(2, samplesPerBlock, false, true, true); // clears
-    tempBuffer.setSize(2, samplesPerBlock, false, true, true); // clears
+    spectralBitcrusher.prepare(numChannels);
+    juce::dsp::ProcessSpec spec;
+    spec.maximumBlockSize = samplesPerBlock;
+    spec.numChannels = numChannels;
+    spec.sampleRate = sampleRate;
+    for (auto* delay : { &dryDelay, &tempDelay }) {
+        delay->setMaximumDelayInSamples(SpectralBitcrusher::getLatencySamples(SpectralBitcrusher::maxOrder));
+        delay->prepare(spec);
+    }
+    prepareSkippedLane(sampleRate, samplesPerBlock, SpectralBitcrusher::getLatencySamples(SpectralBitcrusher::maxOrder));
+
+    // the domain is selected again (and the STFT cleared) by updateDSPState
+    spectralDomain = false;
+    latencySamples = 0;
+    dryDelay.setDelay(0.f);
+    tempDelay.setDelay(0.f);
+
     updateDSPState(sampleRate);
+    prepareBypassFade(sampleRate, bypassed);
+    // symmetry and bias are ramped per sample, so their automation doesn't zipper
+    symmetry.reset(sampleRate, 0.05);
+    bias.reset(sampleRate, 0.05);
+    noiseGenerators.resize((size_t)numChannels);
+    seedNoiseGenerators(fixedSeed);
+
+    // the first sample is held right away
+    holdPhase = 1.f;
+    heldSamples.assign((size_t)numChannels, 0.f);
+}
+
+int BitcrusherModuleDSP::getTailSamples()
+{
+    // bypassed, only the dry delay is left
+    if (isFullyBypassed()) {
+        return latencySamples;
+    }
+    // the frames still being overlapped are output after the latency
+    if (spectralDomain) {
+        return latencySamples + (1 << spectralBitcrusher.getOrder());
+    }
+    return holdTailSamples;
+}
+
+int BitcrusherModuleDSP::getLatencySamples()
+{
+    return latencySamples;
+}
+
+bool BitcrusherModuleDSP::isIdle() noexcept
+{
+    return isDryOnly(parameterHandles.bypassed, parameterHandles.mix, wetGain);
+}
+
+void BitcrusherModuleDSP::resetChannelState() noexcept
+{
+    DSPModule::resetChannelState();
+    std::fill(heldSamples.begin(), heldSamples.end(), 0.f);
+    if (spectralDomain)
+        spectralBitcrusher.reset();
+    dryDelay.reset();
+    tempDelay.reset();
+}
+
+void BitcrusherModuleDSP::processIdle(juce::AudioBuffer<float>& buffer) noexcept
+{
+    // the same dry delay of the bypassed processBlock
+    if (latencySamples > 0) {
+        juce::dsp::AudioBlock<float> dryBlock(buffer);
+        dryBlock = dryBlock.getSubsetChannelBlock(0, (size_t)juce::jmin(buffer.getNumChannels(), (int)heldSamples.size()));
+        delayBlock(dryDelay, dryBlock);
+    }
 }
 
 void BitcrusherModuleDSP::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, double sampleRate)
@@ -141,97 +194,147 @@ void BitcrusherModuleDSP::processBlock(juce::AudioBuffer<float>& buffer, juce::M
 
     updateDSPState(sampleRate);
 
-    if (!bypassed) {
+    // the processor never passes more samples than the prepared block size
+    int numSamples = buffer.getNumSamples();
+    const auto numChannels = juce::jmin(buffer.getNumChannels(), (int)heldSamples.size());
 
-        // SAFETY CHECK :::: since some hosts will change buffer sizes without calling prepToPlay (ex: Bitwig)
-        int numSamples = buffer.getNumSamples();
-        if (wetBuffer.getNumSamples() != numSamples)
-        {
-            wetBuffer.setSize(2, numSamples, false, true, true); // clears
-            noiseBuffer.setSize(2, numSamples, false, true, true); // clears
-            tempBuffer.setSize(2, numSamples, false, true, true); // clears
-        }
+    juce::dsp::AudioBlock<float> dryBlock(buffer);
+    dryBlock = dryBlock.getSubsetChannelBlock(0, (size_t)numChannels);
 
-        // PROCESSING
-        
-        // Wet Buffer feeding
-        for (auto channel = 0; channel < 2; channel++)
-            wetBuffer.copyFrom(channel, 0, buffer, channel, 0, numSamples);
-
-        // Drive
-        driveGain.applyGain(wetBuffer, numSamples);
-
-        // Temp Buffer feeding for applying asymmetry
-        for (auto channel = 0; channel < 2; channel++)
-            tempBuffer.copyFrom(channel, 0, wetBuffer, channel, 0, numSamples);
-
-        // Noise building
-        noiseBuffer.clear();
-        Array<float> noise = getWhiteNoise(numSamples);
-        // ADD the noise
-        FloatVectorOperations::add(noiseBuffer.getWritePointer(0), noise.getRawDataPointer(), numSamples);
-        FloatVectorOperations::add(noiseBuffer.getWritePointer(1), noise.getRawDataPointer(), numSamples);
-        // Multiply the noise by the signal ... so 0 signal -> 0 noise
-        FloatVectorOperations::multiply(noiseBuffer.getWritePointer(0), wetBuffer.getWritePointer(0), numSamples);
-        FloatVectorOperations::multiply(noiseBuffer.getWritePointer(1), wetBuffer.getWritePointer(1), numSamples);
-        // Applying gain to the noiseBuffer
-        dither.applyGain(noiseBuffer, numSamples);
-
-        // TODO : frequency-domain bitcrushing (and a way to switch between time/frequency-domain)
-        // parameters: time/freq-domain switch; FFTorder selector; rate/bitRedux performs in the same way in each type of bitcrushing.
-        // see FFTAnalyzerComponent for FFT-related stuff 
-        // https://forum.juce.com/t/issue-with-fft-plugin-inverse-transformation/16630/3
-        // https://forum.juce.com/t/fft-amplitude/28574
-        // tips:
-        // - gestisco analisi FFT come nel FilterModule (possibilit di scelta all'utente tra diversi FFT-order, inizialmente fisso 1024)
-        // - faccio algoritmo che in base al bufferSize e al FFT-order effettui un delay iniziale della riproduzione in quanto non c' abbastanza informazione per 
-        //   effettuare una corretta analisi FFT
-        // - delay del segnale = aggiunta di 0.f in tutti i sample del buffer in uscita
-        // - nel caso in cui il param mix > 0% devo ritardare la riproduzione anche del segnale dry !!
-        // - minore FFT-order - bufferSize => minor delay del segnale
-        // - outputBuffer[i+(2^fft-order / bufferSIze)] = modifiedBuffer[i] -> considerando outputBuffer e modifiedBuffer come array di buffer
-        // - risorse utili: FFTAnalyzerComponent + https://docs.juce.com/master/tutorial_simple_fft.html
-
-
-        // Resampling
-        for (int chan = 0; chan < wetBuffer.getNumChannels(); chan++)
-        {
-            float* data = wetBuffer.getWritePointer(chan);
+    if (isFullyBypassed()) {
+        // the dry signal is delayed anyway, so that the latency reported to the host doesn't depend on the bypass
+        if (latencySamples > 0) {
+            delayBlock(dryDelay, dryBlock);
+        }
+        return;
+    }
 
+    // PROCESSING
+
+    // Noise building (bulk, scaled by the signal inside the kernels so that 0 signal -> 0 noise)
+    auto noiseBuffer = scratchArena->getBuffer(ScratchArena::Noise, numSamples);
+    for (int channel = 0; channel < numChannels; ++channel)
+        noiseGenerators[(size_t)channel].fill(noiseBuffer.getWritePointer(channel), numSamples);
+
+    // parameters computed once per sample for all the channels
+    auto* drive = getRamp(driveGain, 0, numSamples);
+    auto* noiseGain = getRamp(dither, 1, numSamples);
+    auto* symmetryAmount = getRamp(symmetry, 2, numSamples);
+    auto* symmetryBias = getRamp(bias, 3, numSamples);
+    auto* dry = getRamp(dryGain, 4, numSamples);
+    auto* wet = getRamp(wetGain, 5, numSamples);
+    foldBypassFade(dry, wet, numSamples);
+
+    if (spectralDomain) {
+        // Wet and Temp Buffers (borrowed from the scratch arena) feeding with the driven signal
+        auto wetBuffer = scratchArena->getBuffer(ScratchArena::Wet, numSamples);
+        auto tempBuffer = scratchArena->getBuffer(ScratchArena::Temp, numSamples);
+        for (int channel = 0; channel < numChannels; ++channel) {
+            auto* data = buffer.getReadPointer(channel);
+            auto* wetData = wetBuffer.getWritePointer(channel);
+            auto* tempData = tempBuffer.getWritePointer(channel);
             for (int i = 0; i < numSamples; i++)
-            {
-                // REDUCE BIT DEPTH
-                float totalQLevels = powf(2.f, bitRedux.getNextValue());
-                float val = data[i];
-                float remainder = fmodf(val, 1.f / totalQLevels);
-
-                // Quantize
-                data[i] = val - remainder;
-
-                // Rate reduction
-                int rateReductionRatio = sampleRate / rateRedux.getNextValue();
-                if (rateReductionRatio > 1)
-                {
-                    if (i % rateReductionRatio != 0) data[i] = data[i - i % rateReductionRatio];
-                }
+                wetData[i] = tempData[i] = data[i] * drive[i];
+        }
+
+        // FREQUENCY-DOMAIN BITCRUSHING
+        // bit redux quantizes magnitude and phase of the bins, rate redux holds bins like the time-domain sample and hold
+        juce::AudioBuffer<float> crushBuffer(wetBuffer.getArrayOfWritePointers(), numChannels, numSamples);
+        spectralBitcrusher.process(crushBuffer, numSamples, bitRedux.getTargetValue(), getHoldRatio(rateRedux.getTargetValue(), sampleRate));
+        bitRedux.skip(numSamples);
+        rateRedux.skip(numSamples);
+
+        // temp and dry signals aligned with the STFT output
+        juce::dsp::AudioBlock<float> tempBlock(tempBuffer);
+        tempBlock = tempBlock.getSubsetChannelBlock(0, (size_t)numChannels);
+        delayBlock(tempDelay, tempBlock);
+        delayBlock(dryDelay, dryBlock);
+
+        // fused kernel: noise -> asymmetry -> mix, one vectorized loop per channel
+        for (int channel = 0; channel < numChannels; ++channel) {
+            auto* data = buffer.getWritePointer(channel);
+            auto* wetData = wetBuffer.getReadPointer(channel);
+            auto* tempData = tempBuffer.getReadPointer(channel);
+            auto* noise = noiseBuffer.getReadPointer(channel);
+            for (int i = 0; i < numSamples; i++) {
+                auto crushed = asymmetrySample(tempData[i], wetData[i] + noise[i] * tempData[i] * noiseGain[i], symmetryAmount[i], symmetryBias[i]);
+                data[i] = data[i] * dry[i] + crushed * wet[i];
             }
         }
+        return;
+    }
 
-        // Add noise to the processed audio (dithering/further distortion)
-        wetBuffer.addFrom(0, 0, noiseBuffer.getReadPointer(0), numSamples);
-        wetBuffer.addFrom(1, 0, noiseBuffer.getReadPointer(1), numSamples);
+    // drive -> bit depth reduction in a branch-free (vectorized) pass per channel, then rate reduction -> noise ->
+    // asymmetry -> mix in a second pass, which carries the held sample from one sample to the next
+    auto bitsSmoothing = bitRedux.isSmoothing();
+    if (!bitsSmoothing && bitRedux.getTargetValue() != quantizationBits) {
+        // the step changes only with the parameter
+        quantizationBits = bitRedux.getTargetValue();
+        quantizationStep = std::exp2(-quantizationBits);
+        inverseQuantizationStep = 1.f / quantizationStep;
+    }
+    // per sample steps only while the bit depth is smoothing
+    auto* step = scratchArena->getRamp(6);
+    auto* inverseStep = scratchArena->getRamp(7);
+    if (bitsSmoothing) {
+        for (int i = 0; i < numSamples; i++) {
+            step[i] = std::exp2(-bitRedux.getNextValue());
+            inverseStep[i] = 1.f / step[i];
+        }
+    }
 
-        applyAsymmetry(tempBuffer, wetBuffer, symmetry.getNextValue(), bias.getNextValue(), numSamples);
+    // Rate reduction: sample and hold driven by a phase which runs across blocks,
+    // so the result doesn't depend on the host buffer size and the ratio can be fractional.
+    // The phase is the same for every channel: the samples where a new value is held are marked once.
+    // A ratio of 1 holds every sample, which is the signal itself
+    auto* hold = scratchArena->getRamp(8);
+    const auto rateSmoothing = rateRedux.isSmoothing();
+    // the increment is computed once per block while the rate is constant
+    const auto holdIncrement = rateSmoothing ? 0.f : 1.f / getHoldRatio(rateRedux.getTargetValue(), sampleRate);
+    for (int i = 0; i < numSamples; i++) {
+        holdPhase += rateSmoothing ? 1.f / getHoldRatio(rateRedux.getNextValue(), sampleRate) : holdIncrement;
+        hold[i] = holdPhase >= 1.f ? 1.f : 0.f;
+        holdPhase -= std::floor(holdPhase);
+    }
+    if (!rateSmoothing)
+        rateRedux.skip(numSamples);
 
-        // Mixing buffers
-        dryGain.applyGain(buffer, numSamples);
-        wetGain.applyGain(tempBuffer, numSamples);
+    auto* quantized = scratchArena->getRamp(9);
+    for (int channel = 0; channel < numChannels; ++channel) {
+        auto* data = buffer.getWritePointer(channel);
+        auto* noise = noiseBuffer.getReadPointer(channel);
 
-        for (auto channel = 0; channel < 2; channel++)
-            buffer.addFrom(channel, 0, tempBuffer, channel, 0, numSamples);
+        // every driven sample is quantized (truncation towards zero through an int conversion), no branch in the loop
+        if (bitsSmoothing) {
+            for (int i = 0; i < numSamples; i++)
+                quantized[i] = step[i] * static_cast<float>(static_cast<int>(data[i] * drive[i] * inverseStep[i]));
+        }
+        else {
+            for (int i = 0; i < numSamples; i++)
+                quantized[i] = quantizationStep * static_cast<float>(static_cast<int>(data[i] * drive[i] * inverseQuantizationStep));
+        }
+
+        auto heldSample = heldSamples[(size_t)channel];
+        for (int i = 0; i < numSamples; i++) {
+            auto driven = data[i] * drive[i];
+            // only the held samples are kept
+            heldSample = hold[i] != 0.f ? quantized[i] : heldSample;
+
+            // Add noise to the processed audio (dithering/further distortion)
+            auto crushed = asymmetrySample(driven, heldSample + noise[i] * driven * noiseGain[i], symmetryAmount[i], symmetryBias[i]);
+            data[i] = data[i] * dry[i] + crushed * wet[i];
+        }
+        heldSamples[(size_t)channel] = heldSample;
     }
 }
 
+float BitcrusherModuleDSP::getHoldRatio(float rate, double sampleRate) noexcept
+{
+    if (rate >= maxRateRedux)
+        return 1.f;
+    return juce::jmax(1.f, static_cast<float>(sampleRate) / rate);
+}
+
 void BitcrusherModuleDSP::addParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout)
 {
     using namespace juce;
@@ -241,29 +344,67 @@ void BitcrusherModuleDSP::addParameters(juce::AudioProcessorValueTreeState::Para
         layout.add(std::make_unique<AudioParameterFloat>("Bitcrusher Mix " + std::to_string(i), "Bitcrusher Mix " + std::to_string(i), NormalisableRange<float>(0.f, 100.f, 0.01f), 100.f, "Bitcrusher " + std::to_string(i)));
         layout.add(std::make_unique<AudioParameterFloat>("Bitcrusher Symmetry " + std::to_string(i), "Bitcrusher Symmetry " + std::to_string(i), NormalisableRange<float>(-100.f, 100.f, 1.f), 0.f, "Bitcrusher " + std::to_string(i)));
         layout.add(std::make_unique<AudioParameterFloat>("Bitcrusher Bias " + std::to_string(i), "Bitcrusher Bias " + std::to_string(i), NormalisableRange<float>(-0.9f, 0.9f, 0.01f), 0.f, "Bitcrusher " + std::to_string(i)));
-        layout.add(std::make_unique<AudioParameterFloat>("Bitcrusher Rate Redux " + std::to_string(i), "Bitcrusher Rate Redux " + std::to_string(i), NormalisableRange<float>(100.f, 44100.f, 10.f, 0.25f), 44100.f, "Bitcrusher " + std::to_string(i)));
+        layout.add(std::make_unique<AudioParameterFloat>("Bitcrusher Rate Redux " + std::to_string(i), "Bitcrusher Rate Redux " + std::to_string(i), NormalisableRange<float>(100.f, maxRateRedux, 10.f, 0.25f), maxRateRedux, "Bitcrusher " + std::to_string(i)));
         layout.add(std::make_unique<AudioParameterFloat>("Bitcrusher Bit Redux " + std::to_string(i), "Bitcrusher Bit Redux " + std::to_string(i), NormalisableRange<float>(1.f, 16.f, 0.01f, 0.25f), 16.f, "Bitcrusher " + std::to_string(i)));
         layout.add(std::make_unique<AudioParameterFloat>("Bitcrusher Dither " + std::to_string(i), "Bitcrusher Dither " + std::to_string(i), NormalisableRange<float>(0.f, 100.f, 0.01f), 0.f, "Bitcrusher " + std::to_string(i)));
+        layout.add(std::make_unique<AudioParameterChoice>("Bitcrusher Domain " + std::to_string(i), "Bitcrusher Domain " + std::to_string(i), StringArray{ "Time", "Frequency" }, 0, "Bitcrusher " + std::to_string(i)));
+        layout.add(std::make_unique<AudioParameterChoice>("Bitcrusher FFT Order " + std::to_string(i), "Bitcrusher FFT Order " + std::to_string(i), StringArray{ "1024", "2048", "4096" }, 0, "Bitcrusher " + std::to_string(i)));
+        layout.add(std::make_unique<AudioParameterBool>("Bitcrusher Fixed Seed " + std::to_string(i), "Bitcrusher Fixed Seed " + std::to_string(i), false, "Bitcrusher " + std::to_string(i)));
+        addStereoModeParameter(layout, "Bitcrusher", i);
         layout.add(std::make_unique<AudioParameterBool>("Bitcrusher Bypassed " + std::to_string(i), "Bitcrusher Bypassed " + std::to_string(i), false, "Bitcrusher " + std::to_string(i)));
     }
 }
 
 BitcrusherSettings BitcrusherModuleDSP::getSettings(juce::AudioProcessorValueTreeState& apvts, unsigned int chainPosition)
+{
+    return getSettings(getParameterHandles(apvts, chainPosition));
+}
+
+BitcrusherSettings BitcrusherModuleDSP::getSettings(const BitcrusherParameterHandles& handles)
 {
     BitcrusherSettings settings;
 
-    settings.drive = apvts.getRawParameterValue("Bitcrusher Drive " + std::to_string(chainPosition))->load();
-    settings.mix = apvts.getRawParameterValue("Bitcrusher Mix " + std::to_string(chainPosition))->load();
-    settings.symmetry = apvts.getRawParameterValue("Bitcrusher Symmetry " + std::to_string(chainPosition))->load();
-    settings.bias = apvts.getRawParameterValue("Bitcrusher Bias " + std::to_string(chainPosition))->load();
-    settings.rateRedux = apvts.getRawParameterValue("Bitcrusher Rate Redux " + std::to_string(chainPosition))->load();
-    settings.bitRedux = apvts.getRawParameterValue("Bitcrusher Bit Redux " + std::to_string(chainPosition))->load();
-    settings.dither = apvts.getRawParameterValue("Bitcrusher Dither " + std::to_string(chainPosition))->load();
-    settings.bypassed = apvts.getRawParameterValue("Bitcrusher Bypassed " + std::to_string(chainPosition))->load() > 0.5f;
+    settings.drive = handles.drive->load();
+    settings.mix = handles.mix->load();
+    settings.symmetry = handles.symmetry->load();
+    settings.bias = handles.bias->load();
+    settings.rateRedux = handles.rateRedux->load();
+    settings.bitRedux = handles.bitRedux->load();
+    settings.dither = handles.dither->load();
+    settings.domain = static_cast<int>(handles.domain->load());
+    settings.fftOrder = static_cast<int>(handles.fftOrder->load());
+    settings.stereoMode = static_cast<int>(handles.stereoMode->load());
+    settings.fixedSeed = handles.fixedSeed->load() > 0.5f;
+    settings.bypassed = handles.bypassed->load() > 0.5f;
 
     return settings;
 }
 
+BitcrusherParameterHandles BitcrusherModuleDSP::getParameterHandles(juce::AudioProcessorValueTreeState& apvts, unsigned int chainPosition)
+{
+    BitcrusherParameterHandles handles;
+
+    handles.drive = apvts.getRawParameterValue("Bitcrusher Drive " + std::to_string(chainPosition));
+    handles.mix = apvts.getRawParameterValue("Bitcrusher Mix " + std::to_string(chainPosition));
+    handles.symmetry = apvts.getRawParameterValue("Bitcrusher Symmetry " + std::to_string(chainPosition));
+    handles.bias = apvts.getRawParameterValue("Bitcrusher Bias " + std::to_string(chainPosition));
+    handles.rateRedux = apvts.getRawParameterValue("Bitcrusher Rate Redux " + std::to_string(chainPosition));
+    handles.bitRedux = apvts.getRawParameterValue("Bitcrusher Bit Redux " + std::to_string(chainPosition));
+    handles.dither = apvts.getRawParameterValue("Bitcrusher Dither " + std::to_string(chainPosition));
+    handles.domain = apvts.getRawParameterValue("Bitcrusher Domain " + std::to_string(chainPosition));
+    handles.fftOrder = apvts.getRawParameterValue("Bitcrusher FFT Order " + std::to_string(chainPosition));
+    handles.stereoMode = apvts.getRawParameterValue("Bitcrusher Stereo Mode " + std::to_string(chainPosition));
+    handles.fixedSeed = apvts.getRawParameterValue("Bitcrusher Fixed Seed " + std::to_string(chainPosition));
+    handles.bypassed = apvts.getRawParameterValue("Bitcrusher Bypassed " + std::to_string(chainPosition));
+
+    return handles;
+}
+
+void BitcrusherModuleDSP::cacheParameterHandles()
+{
+    parameterHandles = getParameterHandles(apvts, getChainPosition());
+}
+
 //==============================================================================
 
 /* BitcrusherModule GUI */
@@ -286,6 +427,7 @@ BitcrusherModuleGUI::BitcrusherModuleGUI(BiztortionAudioProcessor& p, unsigned i
     bitcrusherDitherSliderAttachment(audioProcessor.apvts, "Bitcrusher Dither " + std::to_string(chainPosition), bitcrusherDitherSlider),
     bitcrusherRateReduxSliderAttachment(audioProcessor.apvts, "Bitcrusher Rate Redux " + std::to_string(chainPosition), bitcrusherRateReduxSlider),
     bitcrusherBitReduxSliderAttachment(audioProcessor.apvts, "Bitcrusher Bit Redux " + std::to_string(chainPosition), bitcrusherBitReduxSlider),
+    fixedSeedButtonAttachment(audioProcessor.apvts, "Bitcrusher Fixed Seed " + std::to_string(chainPosition), fixedSeedButton),
     bypassButtonAttachment(audioProcessor.apvts, "Bitcrusher Bypassed " + std::to_string(chainPosition), bypassButton)
 {
     // title setup
@@ -323,6 +465,25 @@ BitcrusherModuleGUI::BitcrusherModuleGUI(BiztortionAudioProcessor& p, unsigned i
     bitcrusherBitReduxSlider.labels.add({ 0.f, "1" });
     bitcrusherBitReduxSlider.labels.add({ 1.f, "16" });
 
+    fixedSeedButton.setButtonText("Fixed Seed");
+    fixedSeedButton.setColour(juce::ToggleButton::textColourId, juce::Colours::white);
+    fixedSeedButton.setColour(juce::ToggleButton::tickColourId, juce::Colours::white);
+
+    // time/frequency domain
+    auto domainParameter = dynamic_cast<juce::AudioParameterChoice*>(audioProcessor.apvts.getParameter("Bitcrusher Domain " + std::to_string(chainPosition)));
+    auto fftOrderParameter = dynamic_cast<juce::AudioParameterChoice*>(audioProcessor.apvts.getParameter("Bitcrusher FFT Order " + std::to_string(chainPosition)));
+    domainBox.addItemList(domainParameter->choices, 1);
+    fftOrderBox.addItemList(fftOrderParameter->choices, 1);
+    domainBoxAttachment = std::make_unique<ComboBoxAttachment>(audioProcessor.apvts, "Bitcrusher Domain " + std::to_string(chainPosition), domainBox);
+    fftOrderBoxAttachment = std::make_unique<ComboBoxAttachment>(audioProcessor.apvts, "Bitcrusher FFT Order " + std::to_string(chainPosition), fftOrderBox);
+    for (auto* box : { &domainBox, &fftOrderBox }) {
+        box->setColour(juce::ComboBox::backgroundColourId, juce::Colours::darkgrey.withAlpha(0.75f));
+        box->setColour(juce::ComboBox::textColourId, juce::Colours::white);
+        box->setColour(juce::ComboBox::outlineColourId, juce::Colours::white);
+        box->setJustificationType(juce::Justification::centred);
+    }
+    stereoModeBoxAttachment = attachStereoModeBox(stereoModeBox, audioProcessor.apvts, "Bitcrusher Stereo Mode " + std::to_string(chainPosition));
+
     bypassButton.setLookAndFeel(&lnf);
 
     auto safePtr = juce::Component::SafePointer<BitcrusherModuleGUI>(this);
@@ -344,6 +505,9 @@ BitcrusherModuleGUI::BitcrusherModuleGUI(BiztortionAudioProcessor& p, unsigned i
     bitcrusherDitherSlider.setTooltip("Set the amount of white noise applied to the processed signal to add dithering or further noisy distortion");
     bitcrusherRateReduxSlider.setTooltip("Set the sampling rate for the reduction of signal resolution");
     bitcrusherBitReduxSlider.setTooltip("Set the bit depth for the reduction of signal resolution");
+    domainBox.setTooltip("Select time-domain or frequency-domain (STFT) bitcrushing, the latter adds latency");
+    fftOrderBox.setTooltip("Select the FFT size of the frequency-domain bitcrushing");
+    fixedSeedButton.setTooltip("Use the same noise sequence at every playback start (reproducible offline renders)");
 
     for (auto* comp : getAllComps())
     {
@@ -377,6 +541,10 @@ std::vector<juce::Component*> BitcrusherModuleGUI::getAllComps()
         &bitcrusherDitherLabel,
         &bitcrusherRateReduxLabel,
         &bitcrusherBitReduxLabel,
+        &fixedSeedButton,
+        &domainBox,
+        &fftOrderBox,
+        &stereoModeBox,
         // bypass
         &bypassButton
     };
@@ -391,7 +559,11 @@ std::vector<juce::Component*> BitcrusherModuleGUI::getParamComps()
         &biasSlider,
         &bitcrusherDitherSlider,
         &bitcrusherRateReduxSlider,
-        &bitcrusherBitReduxSlider
+        &bitcrusherBitReduxSlider,
+        &fixedSeedButton,
+        &domainBox,
+        &fftOrderBox,
+        &stereoModeBox
     };
 }
 
@@ -407,6 +579,10 @@ void BitcrusherModuleGUI::updateParameters(const juce::Array<juce::var>& values)
     bitcrusherDitherSlider.setValue(*(value++), juce::NotificationType::sendNotificationSync);
     bitcrusherRateReduxSlider.setValue(*(value++), juce::NotificationType::sendNotificationSync);
     bitcrusherBitReduxSlider.setValue(*(value++), juce::NotificationType::sendNotificationSync);
+    fixedSeedButton.setToggleState(*(value++), juce::NotificationType::sendNotificationSync);
+    domainBox.setSelectedItemIndex(*(value++), juce::NotificationType::sendNotificationSync);
+    fftOrderBox.setSelectedItemIndex(*(value++), juce::NotificationType::sendNotificationSync);
+    stereoModeBox.setSelectedItemIndex(*(value++), juce::NotificationType::sendNotificationSync);
 }
 
 void BitcrusherModuleGUI::resetParameters(unsigned int chainPosition)
@@ -418,6 +594,10 @@ void BitcrusherModuleGUI::resetParameters(unsigned int chainPosition)
     auto rateRedux = audioProcessor.apvts.getParameter("Bitcrusher Rate Redux " + std::to_string(chainPosition));
     auto bitRedux = audioProcessor.apvts.getParameter("Bitcrusher Bit Redux " + std::to_string(chainPosition));
     auto dither = audioProcessor.apvts.getParameter("Bitcrusher Dither " + std::to_string(chainPosition));
+    auto fixedSeed = audioProcessor.apvts.getParameter("Bitcrusher Fixed Seed " + std::to_string(chainPosition));
+    auto domain = audioProcessor.apvts.getParameter("Bitcrusher Domain " + std::to_string(chainPosition));
+    auto fftOrder = audioProcessor.apvts.getParameter("Bitcrusher FFT Order " + std::to_string(chainPosition));
+    auto stereoMode = audioProcessor.apvts.getParameter("Bitcrusher Stereo Mode " + std::to_string(chainPosition));
     auto bypassed = audioProcessor.apvts.getParameter("Bitcrusher Bypassed " + std::to_string(chainPosition));
 
     drive->setValueNotifyingHost(drive->getDefaultValue());
@@ -427,6 +607,10 @@ void BitcrusherModuleGUI::resetParameters(unsigned int chainPosition)
     rateRedux->setValueNotifyingHost(rateRedux->getDefaultValue());
     bitRedux->setValueNotifyingHost(bitRedux->getDefaultValue());
     dither->setValueNotifyingHost(dither->getDefaultValue());
+    fixedSeed->setValueNotifyingHost(fixedSeed->getDefaultValue());
+    domain->setValueNotifyingHost(domain->getDefaultValue());
+    fftOrder->setValueNotifyingHost(fftOrder->getDefaultValue());
+    stereoMode->setValueNotifyingHost(stereoMode->getDefaultValue());
     bypassed->setValueNotifyingHost(bypassed->getDefaultValue());
 }
 
@@ -442,6 +626,10 @@ juce::Array<juce::var> BitcrusherModuleGUI::getParamValues()
     values.add(juce::var(bitcrusherDitherSlider.getValue()));
     values.add(juce::var(bitcrusherRateReduxSlider.getValue()));
     values.add(juce::var(bitcrusherBitReduxSlider.getValue()));
+    values.add(juce::var(fixedSeedButton.getToggleState()));
+    values.add(juce::var(domainBox.getSelectedItemIndex()));
+    values.add(juce::var(fftOrderBox.getSelectedItemIndex()));
+    values.add(juce::var(stereoModeBox.getSelectedItemIndex()));
 
     return values;
 }
@@ -468,6 +656,13 @@ void BitcrusherModuleGUI::resized()
     auto titleAndBypassArea = bitcrusherArea.removeFromTop(30);
     titleAndBypassArea.translate(0, 4);
 
+    // fixed seed on the left of the bypass button, domain, FFT order and stereo mode on the right of the title
+    auto optionsArea = titleAndBypassArea;
+    fixedSeedButton.setBounds(optionsArea.removeFromLeft(125).reduced(5, 4));
+    stereoModeBox.setBounds(optionsArea.removeFromRight(85).reduced(4, 3));
+    fftOrderBox.setBounds(optionsArea.removeFromRight(65).reduced(4, 3));
+    domainBox.setBounds(optionsArea.removeFromRight(95).reduced(4, 3));
+
     bitcrusherArea.translate(0, 8);
 
     auto topArea = bitcrusherArea.removeFromTop(bitcrusherArea.getHeight() * (1.f / 2.f));
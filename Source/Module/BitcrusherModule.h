@@ -44,6 +44,8 @@ along with Biztortion. If not, see < http://www.gnu.org/licenses/>.
 #include "DSPModule.h"
 #include "GUIModule.h"
 #include "../Shared/GUIStuff.h"
+#include "../Shared/NoiseGenerator.h"
+#include "../Shared/SpectralBitcrusher.h"
 class BiztortionAudioProcessor;
 
 //==============================================================================
@@ -56,32 +58,82 @@ struct BitcrusherSettings {
     float mix{ 0 }, drive{ 0 };
     float symmetry{ 0 }, bias{ 0 };
     float rateRedux{ 0 }, bitRedux{ 0 }, dither{ 0 };
+    // domain: 0 = time, 1 = frequency; fftOrder: 0 = 1024 ... 2 = 4096
+    int domain{ 0 }, fftOrder{ 0 };
+    // StereoMode
+    int stereoMode{ 0 };
+    bool fixedSeed{ false };
     bool bypassed{ false };
 };
 
+// APVTS parameters of one Bitcrusher chain slot
+struct BitcrusherParameterHandles {
+    std::atomic<float>* mix{ nullptr }, * drive{ nullptr };
+    std::atomic<float>* symmetry{ nullptr }, * bias{ nullptr };
+    std::atomic<float>* rateRedux{ nullptr }, * bitRedux{ nullptr }, * dither{ nullptr };
+    std::atomic<float>* domain{ nullptr }, * fftOrder{ nullptr };
+    std::atomic<float>* stereoMode{ nullptr };
+    std::atomic<float>* fixedSeed{ nullptr };
+    std::atomic<float>* bypassed{ nullptr };
+};
 
 class BitcrusherModuleDSP : public DSPModule {
 public:
     BitcrusherModuleDSP(juce::AudioProcessorValueTreeState& _apvts);
 
-    Array<float> getWhiteNoise(int numSamples);
-
     void setModuleType() override;
     void updateDSPState(double sampleRate) override;
-    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels) override;
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, double sampleRate) override;
+    int getLatencySamples() override;
+    int getTailSamples() override;
+    bool isIdle() noexcept override;
+    void processIdle(juce::AudioBuffer<float>& buffer) noexcept override;
 
     static void addParameters(juce::AudioProcessorValueTreeState::ParameterLayout&);
     static BitcrusherSettings getSettings(juce::AudioProcessorValueTreeState& apvts, unsigned int chainPosition);
+    static BitcrusherSettings getSettings(const BitcrusherParameterHandles& handles);
+    static BitcrusherParameterHandles getParameterHandles(juce::AudioProcessorValueTreeState& apvts, unsigned int chainPosition);
+
+protected:
+    void cacheParameterHandles() override;
+    void resetChannelState() noexcept override;
 
 private:
 
+    // with a fixed seed the noise only depends on the chain position, for reproducible offline renders
+    void seedNoiseGenerators(bool fixedSeed);
+    // samples covered by each held sample (>= 1). The top of the rate range (the default) and any rate at or
+    // above the sample rate give 1, so the rate reduction passes the signal through at every sample rate
+    static float getHoldRatio(float rate, double sampleRate) noexcept;
+    static constexpr float maxRateRedux = 44100.f;
+
+    BitcrusherParameterHandles parameterHandles;
     bool bypassed = false;
-    juce::AudioBuffer<float> wetBuffer, noiseBuffer, tempBuffer;
     juce::LinearSmoothedValue<float> symmetry, bias;
     juce::LinearSmoothedValue<float> driveGain, dryGain, wetGain, dither;
     juce::LinearSmoothedValue<float> rateRedux, bitRedux;
 
+    // one independent stream per channel
+    std::vector<GaussianNoiseGenerator> noiseGenerators;
+    bool fixedSeed = false;
+
+    // quantization step (and its inverse) cached for the current bit depth
+    float quantizationBits = 0.f, quantizationStep = 1.f, inverseQuantizationStep = 1.f;
+    // sample and hold state, kept between blocks
+    float holdPhase = 1.f;
+    // one held sample per channel
+    std::vector<float> heldSamples;
+    // the last held sample lasts until the next hold, at most one period of the target rate
+    int holdTailSamples = 0;
+
+    // frequency-domain bitcrushing: the dry and the temp (asymmetry) signals are delayed
+    // by the STFT latency to stay aligned with the crushed one
+    SpectralBitcrusher spectralBitcrusher;
+    bool spectralDomain = false;
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> dryDelay, tempDelay;
+    int latencySamples = 0;
+
 };
 
 //==============================================================================
@@ -109,6 +161,7 @@ private:
     using APVTS = juce::AudioProcessorValueTreeState;
     using Attachment = APVTS::SliderAttachment;
     using ButtonAttachment = APVTS::ButtonAttachment;
+    using ComboBoxAttachment = APVTS::ComboBoxAttachment;
 
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
@@ -137,9 +190,17 @@ private:
         bitcrusherRateReduxSliderAttachment,
         bitcrusherBitReduxSliderAttachment;
 
+    juce::ToggleButton fixedSeedButton;
+    juce::ComboBox domainBox, fftOrderBox;
+    // created once the boxes are filled with the parameter choices
+    std::unique_ptr<ComboBoxAttachment> domainBoxAttachment, fftOrderBoxAttachment;
+    juce::ComboBox stereoModeBox;
+    std::unique_ptr<ComboBoxAttachment> stereoModeBoxAttachment;
+
     PowerButton bypassButton;
 
-    ButtonAttachment bypassButtonAttachment;
+    ButtonAttachment fixedSeedButtonAttachment,
+        bypassButtonAttachment;
 
     ButtonsLookAndFeel lnf;
 
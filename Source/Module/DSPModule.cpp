@@ -42,6 +42,22 @@ unsigned int DSPModule::getChainPosition()
 void DSPModule::setChainPosition(unsigned int cp)
 {
     chainPosition = cp;
+    cacheParameterHandles();
+}
+
+void DSPModule::setScratchArena(ScratchArena* arena)
+{
+    scratchArena = arena;
+}
+
+void DSPModule::setWorkerPool(const std::atomic<RealtimeWorkerPool*>* pool)
+{
+    workerPool = pool;
+}
+
+RealtimeWorkerPool* DSPModule::getWorkerPool() const noexcept
+{
+    return workerPool != nullptr ? workerPool->load(std::memory_order_acquire) : nullptr;
 }
 
 ModuleType DSPModule::getModuleType()
@@ -49,40 +65,176 @@ ModuleType DSPModule::getModuleType()
     return moduleType;
 }
 
-void DSPModule::applyAsymmetry(juce::AudioBuffer<float>& drySignal, juce::AudioBuffer<float>& wetSignal, float symmetryAmount, float symmetryBias, int numSamples)
-{
-    float dryGain = std::abs(symmetryAmount);
-    float wetGain = 1 - dryGain;
-
-    for (auto channel = 0; channel < 2; ++channel)
-    {
-        auto* wetData = wetSignal.getWritePointer(channel);
-        auto* bufferData = drySignal.getWritePointer(channel);
-        for (auto i = 0; i < numSamples; ++i) {
-            if (symmetryAmount == 0.f) {
-                bufferData[i] = wetData[i];
-            }
-            else if (symmetryAmount > 0.f) {
-                if (bufferData[i] < -symmetryBias) {
-                    bufferData[i] = sumSignals(bufferData[i], 0.f, wetData[i], 1.f);
-                }
-                else {
-                    bufferData[i] = sumSignals(bufferData[i], dryGain, wetData[i], wetGain);
-                }
-            }
-            else {
-                if (bufferData[i] >= -symmetryBias) {
-                    bufferData[i] = sumSignals(bufferData[i], 0.f, wetData[i], 1.f);
-                }
-                else {
-                    bufferData[i] = sumSignals(bufferData[i], dryGain, wetData[i], wetGain);
-                }
-            }
-        }
+int DSPModule::getLatencySamples()
+{
+    return 0;
+}
+
+int DSPModule::getTailSamples()
+{
+    return 0;
+}
+
+bool DSPModule::canSleep(bool inputSilent, int numSamples) noexcept
+{
+    if (!inputSilent) {
+        silentInputSamples = 0;
+        return false;
+    }
+    if (isTailSilent(silentInputSamples))
+        return true;
+    // the block is processed and counts towards the tail
+    if (silentInputSamples < std::numeric_limits<int>::max() - numSamples)
+        silentInputSamples += numSamples;
+    return false;
+}
+
+bool DSPModule::isTailSilent(int silentSamples)
+{
+    return silentSamples >= getTailSamples();
+}
+
+bool DSPModule::isIdle() noexcept
+{
+    return false;
+}
+
+void DSPModule::processIdle(juce::AudioBuffer<float>& buffer) noexcept
+{
+    juce::ignoreUnused(buffer);
+}
+
+bool DSPModule::isDryOnly(const std::atomic<float>* bypassed, const std::atomic<float>* mix, const juce::LinearSmoothedValue<float>& wetGain) const noexcept
+{
+    // the module is processed until the bypass fade (started by the first block after the switch) is over
+    if (bypassed->load() > 0.5f)
+        return isFullyBypassed();
+    // turning the mix down to 0 doesn't click: the module is processed until the wet gain gets there
+    return mix->load() <= 0.f && !wetGain.isSmoothing() && wetGain.getTargetValue() <= 0.f;
+}
+
+void DSPModule::prepareBypassFade(double sampleRate, bool bypassed)
+{
+    bypassFade.reset(sampleRate, bypassFadeSeconds);
+    bypassFade.setCurrentAndTargetValue(bypassed ? 1.f : 0.f);
+}
+
+void DSPModule::fadeIn() noexcept
+{
+    // the next updateDSPState sets the target back to the bypass parameter
+    bypassFade.setCurrentAndTargetValue(1.f);
+}
+
+void DSPModule::setBypassFadeTarget(bool bypassed) noexcept
+{
+    bypassFade.setTargetValue(bypassed ? 1.f : 0.f);
+}
+
+bool DSPModule::isFullyBypassed() const noexcept
+{
+    return !bypassFade.isSmoothing() && bypassFade.getTargetValue() >= 1.f;
+}
+
+bool DSPModule::getBypassFade(int numSamples, const float*& processedGain, const float*& dryGain) noexcept
+{
+    if (!bypassFade.isSmoothing() && bypassFade.getTargetValue() <= 0.f)
+        return false;
+
+    auto* processed = scratchArena->getRamp(bypassFadeRamp);
+    auto* dry = scratchArena->getRamp(bypassFadeRamp + 1);
+    for (auto i = 0; i < numSamples; ++i) {
+        const auto angle = bypassFade.getNextValue() * juce::MathConstants<float>::halfPi;
+        processed[i] = std::cos(angle);
+        dry[i] = std::sin(angle);
+    }
+    processedGain = processed;
+    dryGain = dry;
+    return true;
+}
+
+void DSPModule::foldBypassFade(const float*& dry, const float*& wet, int numSamples) noexcept
+{
+    const float* processedGain;
+    const float* dryGain;
+    if (!getBypassFade(numSamples, processedGain, dryGain))
+        return;
+
+    // in place in the fade ramps
+    auto* fadedWet = scratchArena->getRamp(bypassFadeRamp);
+    auto* fadedDry = scratchArena->getRamp(bypassFadeRamp + 1);
+    for (auto i = 0; i < numSamples; ++i) {
+        const auto processed = processedGain[i];
+        fadedDry[i] = dry[i] * processed + dryGain[i];
+        fadedWet[i] = wet[i] * processed;
     }
+    dry = fadedDry;
+    wet = fadedWet;
 }
 
-float DSPModule::sumSignals(float drySignal, float dryGain, float wetSignal, float wetGain)
+StereoMode DSPModule::getStereoMode() const noexcept
 {
-    return (drySignal * dryGain) + (wetSignal * wetGain);
+    return stereoMode;
+}
+
+void DSPModule::setLaneStereoMode(StereoMode mode) noexcept
+{
+    if (mode == laneStereoMode)
+        return;
+
+    laneStereoMode = mode;
+    resetChannelState();
+}
+
+void DSPModule::resetChannelState() noexcept
+{
+    skippedLaneDelay.reset();
+}
+
+void DSPModule::delaySkippedLane(float* data, int numSamples, int latency) noexcept
+{
+    jassert(latency <= skippedLaneMaxLatency);
+    if (latency <= 0 || latency > skippedLaneMaxLatency)
+        return;
+
+    if (latency != skippedLaneLatency) {
+        // same as the delays of the processed lanes: a new latency starts from silence
+        skippedLaneLatency = latency;
+        skippedLaneDelay.reset();
+        skippedLaneDelay.setDelay((float)latency);
+    }
+    for (auto i = 0; i < numSamples; ++i) {
+        skippedLaneDelay.pushSample(0, data[i]);
+        data[i] = skippedLaneDelay.popSample(0);
+    }
+}
+
+void DSPModule::addStereoModeParameter(juce::AudioProcessorValueTreeState::ParameterLayout& layout, const std::string& moduleName, int chainPosition)
+{
+    auto id = moduleName + " Stereo Mode " + std::to_string(chainPosition);
+    // same order as StereoMode
+    layout.add(std::make_unique<juce::AudioParameterChoice>(id, id, juce::StringArray{ "Stereo", "Mid/Side", "Mid Only", "Side Only" }, 0, moduleName + " " + std::to_string(chainPosition)));
+}
+
+void DSPModule::prepareSkippedLane(double sampleRate, int samplesPerBlock, int maxLatency)
+{
+    juce::dsp::ProcessSpec spec;
+    spec.maximumBlockSize = samplesPerBlock;
+    spec.numChannels = 1;
+    spec.sampleRate = sampleRate;
+    skippedLaneDelay.setMaximumDelayInSamples(juce::jmax(1, maxLatency));
+    skippedLaneDelay.prepare(spec);
+    skippedLaneMaxLatency = maxLatency;
+    skippedLaneLatency = 0;
+}
+
+const float* DSPModule::getRamp(juce::LinearSmoothedValue<float>& value, int index, int numSamples) noexcept
+{
+    auto* ramp = scratchArena->getRamp(index);
+    if (!value.isSmoothing()) {
+        juce::FloatVectorOperations::fill(ramp, value.getTargetValue(), numSamples);
+        return ramp;
+    }
+    for (auto i = 0; i < numSamples; ++i)
+        ramp[i] = value.getNextValue();
+    return ramp;
 }
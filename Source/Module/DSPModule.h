@@ -31,6 +31,8 @@ along with Biztortion. If not, see < http://www.gnu.org/licenses/>.
 
 #include <JuceHeader.h>
 #include <string>
+#include "../Shared/RealtimeWorkerPool.h"
+#include "../Shared/ScratchArena.h"
 
 enum ModuleType {
     Uninstantiated,
@@ -42,35 +44,188 @@ enum ModuleType {
     SlewLimiter
 };
 
+// how a processing slot (Filter, Waveshaper, Bitcrusher, SlewLimiter) treats the first two channels:
+// left/right, encoded to mid/side around the module, or mid/side with only one lane processed
+enum StereoMode {
+    LeftRight,
+    MidSide,
+    MidOnly,
+    SideOnly
+};
+
 class DSPModule {
 public:
+    // channels of the widest supported layout (7.1)
+    static constexpr int maxNumChannels = 8;
+    // below this (-120 dB) a block is silent
+    static constexpr float silenceThreshold = 1.0e-6f;
+
     DSPModule(juce::AudioProcessorValueTreeState& _apvts);
+    virtual ~DSPModule() = default;
     unsigned int getChainPosition();
     void setChainPosition(unsigned int cp);
+    // temporary buffers shared by the modules, owned by the processor
+    void setScratchArena(ScratchArena* arena);
+    // threads to run the independent lanes of a module concurrently: the processor owns the pointer,
+    // which is null while multicore processing is off
+    void setWorkerPool(const std::atomic<RealtimeWorkerPool*>* pool);
     ModuleType getModuleType();
     virtual void setModuleType() = 0;
     virtual void updateDSPState(double sampleRate) = 0;
-    virtual void prepareToPlay(double sampleRate, int samplesPerBlock) = 0;
+    // numChannels: the channels of the processor layout (1 to maxNumChannels), the per channel state is sized here
+    virtual void prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels) = 0;
     virtual void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&, double) = 0;
+    // latency introduced by the module, summed by the processor and reported to the host
+    virtual int getLatencySamples();
+    // samples the output keeps going after the input becomes silent (ringing, held samples, delayed dry signal)
+    virtual int getTailSamples();
+    /**
+    * Silence detection, called by the chain before every block of a processing slot
+    *
+    * @param    inputSilent whether the block entering the module is below silenceThreshold
+    * @param    numSamples the number of samples of the block
+    * @return   true if the module can skip the block: its input is silent and its state is too
+    */
+    bool canSleep(bool inputSilent, int numSamples) noexcept;
+    // whether the module leaves the signal as it is (bypassed, mixed at 0, nobody looking at it), so that the chain
+    // leaves it out of its active plan. Called by the thread processing the module: it reads atomics and its own state only
+    virtual bool isIdle() noexcept;
+    // idle modules with latency keep delaying the signal, so that the latency reported to the host doesn't change
+    virtual void processIdle(juce::AudioBuffer<float>& buffer) noexcept;
+    // called after prepareToPlay by a module entering the running chain: it starts from the dry signal and fades in
+    void fadeIn() noexcept;
+    // stereo mode of the slot, applied by the chain around processBlock
+    StereoMode getStereoMode() const noexcept;
+    // audio thread: the chain calls this with the stereo mode of every processed block. A mode switch moves the lanes to
+    // other channels of the module (mid only / side only pass one lane), so the channel state is cleared then
+    void setLaneStereoMode(StereoMode mode) noexcept;
+    /**
+    * Mid only / side only: delays the lane the module skips by the module latency, so that it stays aligned
+    * with the processed one when they are decoded back to left/right
+    *
+    * @param    data the samples of the skipped lane
+    * @param    numSamples the number of samples, at most the prepared block size
+    * @param    latency the latency of the module in this block
+    */
+    void delaySkippedLane(float* data, int numSamples, int latency) noexcept;
+
+    // adds the "<moduleName> Stereo Mode <chainPosition>" choice parameter of a processing slot
+    static void addStereoModeParameter(juce::AudioProcessorValueTreeState::ParameterLayout& layout, const std::string& moduleName, int chainPosition);
 
 protected:
     juce::AudioProcessorValueTreeState& apvts;
     // 0 - 9
     unsigned int chainPosition;
-    ModuleType moduleType;
+    ScratchArena* scratchArena = nullptr;
+    const std::atomic<RealtimeWorkerPool*>* workerPool = nullptr;
+    // audio thread: the pool to use for this block, null when the lanes must run inline
+    RealtimeWorkerPool* getWorkerPool() const noexcept;
+    ModuleType moduleType = ModuleType::Uninstantiated;
+    // set by updateDSPState of the processing modules
+    StereoMode stereoMode = StereoMode::LeftRight;
+    // clears the per channel state (filters, delays, held samples) without allocating
+    virtual void resetChannelState() noexcept;
+
+    // modules with latency call this in prepareToPlay, maxLatency is the highest latency they can report
+    void prepareSkippedLane(double sampleRate, int samplesPerBlock, int maxLatency);
+
+    // called by setChainPosition: modules resolve here the APVTS parameters of their chain slot once,
+    // so that the audio thread never builds parameter IDs or searches the APVTS
+    virtual void cacheParameterHandles() {}
+
+    // whether the state is silent after silentSamples samples of silent input (by default: once the tail is over)
+    virtual bool isTailSilent(int silentSamples);
+
+    // isIdle of the processing modules: bypassed once the bypass fade is over, or mixed at 0 once the wet gain has faded out
+    bool isDryOnly(const std::atomic<float>* bypassed, const std::atomic<float>* mix, const juce::LinearSmoothedValue<float>& wetGain) const noexcept;
+
+    // bypass crossfade: called by prepareToPlay, after updateDSPState, the fade starts from the current bypass state
+    void prepareBypassFade(double sampleRate, bool bypassed);
+    // called by updateDSPState with the bypass parameter
+    void setBypassFadeTarget(bool bypassed) noexcept;
+    // the fade to the dry signal is over: the module only delays the signal by its latency
+    bool isFullyBypassed() const noexcept;
+    /**
+    * Advances the equal-power bypass crossfade by numSamples
+    *
+    * @param    processedGain the gains of the processed signal, cos of the fade (scratch ramp bypassFadeRamp)
+    * @param    dryGain the gains of the dry signal, sin of the fade (scratch ramp bypassFadeRamp + 1)
+    * @return   false while the module isn't fading in or out: the gains aren't filled and the processed signal goes out as it is
+    */
+    bool getBypassFade(int numSamples, const float*& processedGain, const float*& dryGain) noexcept;
+    /**
+    * Folds the bypass crossfade into the mix ramps of a module: wet <- wet * cos, dry <- dry * cos + sin.
+    * Nothing is done while the module isn't fading
+    *
+    * @param    dry the dry gains of the block, replaced by the faded ones
+    * @param    wet the wet gains of the block, replaced by the faded ones
+    */
+    void foldBypassFade(const float*& dry, const float*& wet, int numSamples) noexcept;
+
+    /**
+    * Advances a smoothed parameter by numSamples and returns its values, so that the kernels compute
+    * them once per sample and then run one (vectorizable) loop per channel
+    *
+    * @param    value the smoothed parameter
+    * @param    index the ramp of the scratch arena to fill, distinct for every parameter used at the same time
+    * @param    numSamples the number of samples, at most the prepared block size
+    * @return   numSamples values, valid until the ramp is borrowed again
+    */
+    const float* getRamp(juce::LinearSmoothedValue<float>& value, int index, int numSamples) noexcept;
+
+    /**
+    * Same as DelayLine::process, but the block may have fewer channels than the delay was prepared with
+    * (a mid only / side only slot passes one lane)
+    *
+    * @param    delay the delay line, its channels are used in block order
+    * @param    block the samples to delay in place
+    */
+    template <typename Delay>
+    static void delayBlock(Delay& delay, juce::dsp::AudioBlock<float>& block) noexcept
+    {
+        for (size_t channel = 0; channel < block.getNumChannels(); ++channel) {
+            auto* data = block.getChannelPointer(channel);
+            for (size_t i = 0; i < block.getNumSamples(); ++i) {
+                delay.pushSample((int)channel, data[i]);
+                data[i] = delay.popSample((int)channel);
+            }
+        }
+    }
 
     /**
-    * Use this function only in distortion modules to apply asymmetry (if symmetryBias !=0, else is normal symmetry)
+    * Use this function only in distortion modules to apply asymmetry (if symmetryBias !=0, else is normal symmetry),
+    * in their fused (one pass) kernels.
     * symmetryBias range is -0.9/+0.9 so select carefully your bias in order to apply the desired asymmetry effect
-    * 
-    * @param    drySignal the original signal before processing [WARNING: the function does side effect to this buffer!]
-    * @param    wetSignal the signal after being processed
+    *
+    * @param    drySample the sample before processing
+    * @param    wetSample the sample after processing
     * @param    symmetryAmount determines the percentage of wet signal in the positive or negative part of the waveform
     * @param    symmetryBias determines the threshold to determine the separation between positive and negative phase of the waveform
-    * @param    numSamples determines the number of samples in the buffer
+    * @return   the asymmetric blend of drySample and wetSample
     */
-    void applyAsymmetry(juce::AudioBuffer<float>& drySignal, juce::AudioBuffer<float>& wetSignal, float symmetryAmount, float symmetryBias, int numSamples);
+    static inline float asymmetrySample(float drySample, float wetSample, float symmetryAmount, float symmetryBias) noexcept
+    {
+        // branch-free: only selects between values, so the loops calling this are vectorized with compares and blends.
+        // symmetryAmount > 0 blends the part of the waveform above -symmetryBias, symmetryAmount < 0 the part below;
+        // symmetryAmount == 0 -> dryGain == 0, so the result is the wet sample in both phases
+        const auto dryGain = std::abs(symmetryAmount);
+        const auto positiveGain = symmetryAmount > 0.f ? dryGain : 0.f;
+        const auto negativeGain = symmetryAmount > 0.f ? 0.f : dryGain;
+        const auto gain = drySample >= -symmetryBias ? positiveGain : negativeGain;
+        return wetSample + gain * (drySample - wetSample);
+    }
 
 private:
-    float sumSignals(float drySignal, float dryGain, float wetSignal, float wetGain);
+    // consecutive samples of silent input processed, reset by the first sound
+    int silentInputSamples = 0;
+    // 0 = processed, 1 = bypassed
+    juce::LinearSmoothedValue<float> bypassFade;
+    static constexpr double bypassFadeSeconds = 0.02;
+    // the scratch ramps of the fade gains, above the ones of the module parameters
+    static constexpr int bypassFadeRamp = 10;
+    // the lane skipped by a mid only / side only slot (modules without latency never use it)
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> skippedLaneDelay;
+    int skippedLaneMaxLatency = 0, skippedLaneLatency = 0;
+    // the stereo mode the channel state was built with
+    StereoMode laneStereoMode = StereoMode::LeftRight;
 };
\ No newline at end of file
@@ -46,8 +46,34 @@ along with Biztortion. If not, see < http://www.gnu.org/licenses/>.
 
 //==============================================================================
 
+FilterDesignThread::FilterDesignThread()
+    : juce::TimeSliceThread("Biztortion Filter Design") {
+    startThread(3);
+}
+
+FilterDesignThread::~FilterDesignThread() {
+    stopThread(1000);
+}
+
+FilterDesign::FilterDesign() {
+    // allocated here once, the design thread only overwrites their values
+    for (auto& coefficients : lowCut)
+        coefficients = new juce::dsp::IIR::Coefficients<double>(1.0, 0.0, 0.0, 1.0, 0.0, 0.0);
+    for (auto& coefficients : highCut)
+        coefficients = new juce::dsp::IIR::Coefficients<double>(1.0, 0.0, 0.0, 1.0, 0.0, 0.0);
+    peak = new juce::dsp::IIR::Coefficients<double>(1.0, 0.0, 0.0, 1.0, 0.0, 0.0);
+}
+
 FilterModuleDSP::FilterModuleDSP(juce::AudioProcessorValueTreeState& _apvts)
     : DSPModule(_apvts) {
+    designThread->addTimeSliceClient(this);
+}
+
+FilterModuleDSP::~FilterModuleDSP() {
+    // waits for a running design to finish
+    designThread->removeTimeSliceClient(this);
+    for (auto& id : listenedParameterIDs)
+        apvts.removeParameterListener(id, this);
 }
 
 void updateCoefficients(Coefficients& old, const Coefficients& replacements) {
@@ -55,29 +81,208 @@ void updateCoefficients(Coefficients& old, const Coefficients& replacements) {
     *old = *replacements;
 }
 
-Coefficients FilterModuleDSP::makePeakFilter(const FilterChainSettings& chainSettings, double sampleRate) {
-    return juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate,
-        chainSettings.peakFreq, chainSettings.peakQuality,
-        juce::Decibels::decibelsToGain(chainSettings.peakGainInDecibels));
+void updateCoefficients(PrecisionCoefficients& old, const PrecisionCoefficients& replacements) {
+    *old = *replacements;
 }
 
 FilterChainSettings FilterModuleDSP::getSettings(juce::AudioProcessorValueTreeState& apvts, unsigned int chainPosition) {
+    return getSettings(getParameterHandles(apvts, chainPosition));
+}
+
+FilterChainSettings FilterModuleDSP::getSettings(const FilterParameterHandles& handles) {
     FilterChainSettings settings;
 
-    settings.lowCutFreq = apvts.getRawParameterValue("LowCut Freq " + std::to_string(chainPosition))->load();
-    settings.highCutFreq = apvts.getRawParameterValue("HighCut Freq " + std::to_string(chainPosition))->load();
-    settings.peakFreq = apvts.getRawParameterValue("Peak Freq " + std::to_string(chainPosition))->load();
-    settings.peakGainInDecibels = apvts.getRawParameterValue("Peak Gain " + std::to_string(chainPosition))->load();
-    settings.peakQuality = apvts.getRawParameterValue("Peak Quality " + std::to_string(chainPosition))->load();
-    settings.lowCutSlope = apvts.getRawParameterValue("LowCut Slope " + std::to_string(chainPosition))->load();
-    settings.highCutSlope = apvts.getRawParameterValue("HighCut Slope " + std::to_string(chainPosition))->load();
+    settings.lowCutFreq = handles.lowCutFreq->load();
+    settings.highCutFreq = handles.highCutFreq->load();
+    settings.peakFreq = handles.peakFreq->load();
+    settings.peakGainInDecibels = handles.peakGainInDecibels->load();
+    settings.peakQuality = handles.peakQuality->load();
+    settings.lowCutSlope = handles.lowCutSlope->load();
+    settings.highCutSlope = handles.highCutSlope->load();
+    settings.stereoMode = static_cast<int>(handles.stereoMode->load());
     // bypass
-    settings.bypassed = apvts.getRawParameterValue("Filter Bypassed " + std::to_string(chainPosition))->load() > 0.5f;
-    settings.analyzerBypassed = apvts.getRawParameterValue("Filter Analyzer Enabled " + std::to_string(chainPosition))->load() > 0.5f;
+    settings.bypassed = handles.bypassed->load() > 0.5f;
+    settings.analyzerBypassed = handles.analyzerBypassed->load() > 0.5f;
 
     return settings;
 }
 
+FilterParameterHandles FilterModuleDSP::getParameterHandles(juce::AudioProcessorValueTreeState& apvts, unsigned int chainPosition) {
+    FilterParameterHandles handles;
+
+    handles.lowCutFreq = apvts.getRawParameterValue("LowCut Freq " + std::to_string(chainPosition));
+    handles.highCutFreq = apvts.getRawParameterValue("HighCut Freq " + std::to_string(chainPosition));
+    handles.peakFreq = apvts.getRawParameterValue("Peak Freq " + std::to_string(chainPosition));
+    handles.peakGainInDecibels = apvts.getRawParameterValue("Peak Gain " + std::to_string(chainPosition));
+    handles.peakQuality = apvts.getRawParameterValue("Peak Quality " + std::to_string(chainPosition));
+    handles.lowCutSlope = apvts.getRawParameterValue("LowCut Slope " + std::to_string(chainPosition));
+    handles.highCutSlope = apvts.getRawParameterValue("HighCut Slope " + std::to_string(chainPosition));
+    handles.stereoMode = apvts.getRawParameterValue("Filter Stereo Mode " + std::to_string(chainPosition));
+    // bypass
+    handles.bypassed = apvts.getRawParameterValue("Filter Bypassed " + std::to_string(chainPosition));
+    handles.analyzerBypassed = apvts.getRawParameterValue("Filter Analyzer Enabled " + std::to_string(chainPosition));
+
+    return handles;
+}
+
+void FilterModuleDSP::cacheParameterHandles()
+{
+    const juce::ScopedLock lock(designLock);
+
+    for (auto& id : listenedParameterIDs)
+        apvts.removeParameterListener(id, this);
+    listenedParameterIDs.clear();
+
+    parameterHandles = getParameterHandles(apvts, getChainPosition());
+
+    // bypass parameters are read by the audio thread and don't need a redesign
+    for (auto name : { "LowCut Freq ", "HighCut Freq ", "Peak Freq ", "Peak Gain ", "Peak Quality ", "LowCut Slope ", "HighCut Slope " }) {
+        juce::String id = name + std::to_string(getChainPosition());
+        listenedParameterIDs.add(id);
+        apvts.addParameterListener(id, this);
+    }
+    ++parameterGeneration;
+}
+
+void FilterModuleDSP::parameterChanged(const juce::String&, float)
+{
+    // may be called by the audio thread during automation
+    ++parameterGeneration;
+}
+
+int FilterModuleDSP::useTimeSlice()
+{
+    const juce::ScopedTryLock lock(designLock);
+    if (lock.isLocked()) {
+        designCoefficients();
+    }
+    // milliseconds before the next check
+    return 10;
+}
+
+// samples for the impulse response of one section to decay below the silence threshold (from its slowest pole)
+static int getDecaySamples(const PrecisionCoefficients& coefficients, double sampleRate) {
+    // normalized coefficients: b0, b1, a1 (first order) or b0, b1, b2, a1, a2 (second order)
+    const auto* c = coefficients->coefficients.begin();
+    double radius = 0.0;
+    if (coefficients->getFilterOrder() == 1) {
+        radius = std::abs(c[2]);
+    }
+    else if (coefficients->getFilterOrder() == 2) {
+        const auto discriminant = c[3] * c[3] - 4.0 * c[4];
+        radius = discriminant < 0.0 ? std::sqrt(c[4]) : 0.5 * (std::abs(c[3]) + std::sqrt(discriminant));
+    }
+    // at most 10 seconds, even for a (not designable) pole on the unit circle
+    const auto maxSamples = (int)(10.0 * sampleRate);
+    if (radius <= 0.0)
+        return 0;
+    if (radius >= 1.0)
+        return maxSamples;
+    return juce::jmin(maxSamples, (int)std::ceil(std::log((double)DSPModule::silenceThreshold) / std::log(radius)));
+}
+
+void FilterModuleDSP::designCoefficients()
+{
+    // designLock must be held
+    const auto generation = parameterGeneration.load();
+    const auto sampleRate = designSampleRate.load();
+    if ((generation == designedGeneration && sampleRate == designedSampleRate) || sampleRate <= 0.0 || parameterHandles.lowCutFreq == nullptr) {
+        return;
+    }
+
+    auto settings = getSettings(parameterHandles);
+    auto& design = designs[backDesign];
+
+    // JUCE allocates the designed coefficients on the HEAP, only their values are copied into the design
+    auto lowCutCoefficients = makeLowCutFilter<double>(settings, sampleRate);
+    for (int i = 0; i < juce::jmin(lowCutCoefficients.size(), 4); ++i) {
+        updateCoefficients(design.lowCut[i], lowCutCoefficients[i]);
+    }
+    auto highCutCoefficients = makeHighCutFilter<double>(settings, sampleRate);
+    for (int i = 0; i < juce::jmin(highCutCoefficients.size(), 4); ++i) {
+        updateCoefficients(design.highCut[i], highCutCoefficients[i]);
+    }
+    updateCoefficients(design.peak, makePeakFilter<double>(settings, sampleRate));
+    design.lowCutSlope = settings.lowCutSlope;
+    design.highCutSlope = settings.highCutSlope;
+
+    // the sections are in cascade: their tails add up
+    design.tailSamples = getDecaySamples(design.peak, sampleRate);
+    for (int i = 0; i <= design.lowCutSlope; ++i) {
+        design.tailSamples += getDecaySamples(design.lowCut[i], sampleRate);
+    }
+    for (int i = 0; i <= design.highCutSlope; ++i) {
+        design.tailSamples += getDecaySamples(design.highCut[i], sampleRate);
+    }
+
+    designedGeneration = generation;
+    designedSampleRate = sampleRate;
+
+    // publish the back buffer and take the old middle one
+    backDesign = middleDesign.exchange(backDesign | newDesignFlag) & 3;
+}
+
+template<int Index>
+static void setCutStage(PrecisionCutFilter& cutFilter, const std::array<PrecisionCoefficients, 4>& coefficients, int slope) {
+    // the coefficient objects are owned by the designs, so the old ones are never released here
+    cutFilter.get<Index>().coefficients = coefficients[Index];
+    cutFilter.setBypassed<Index>(Index > slope);
+}
+
+static void applyDesignToChain(PrecisionMonoChain& monoChain, const FilterDesign& design) {
+    auto& lowCut = monoChain.get<ChainPositions::LowCut>();
+    setCutStage<0>(lowCut, design.lowCut, design.lowCutSlope);
+    setCutStage<1>(lowCut, design.lowCut, design.lowCutSlope);
+    setCutStage<2>(lowCut, design.lowCut, design.lowCutSlope);
+    setCutStage<3>(lowCut, design.lowCut, design.lowCutSlope);
+
+    monoChain.get<ChainPositions::Peak>().coefficients = design.peak;
+
+    auto& highCut = monoChain.get<ChainPositions::HighCut>();
+    setCutStage<0>(highCut, design.highCut, design.highCutSlope);
+    setCutStage<1>(highCut, design.highCut, design.highCutSlope);
+    setCutStage<2>(highCut, design.highCut, design.highCutSlope);
+    setCutStage<3>(highCut, design.highCut, design.highCutSlope);
+}
+
+template<int Index>
+static void addActiveCutStage(PrecisionCutFilter& cutFilter, std::array<PrecisionFilter*, 9>& sections, int& numSections) {
+    if (!cutFilter.isBypassed<Index>())
+        sections[(size_t)numSections++] = &cutFilter.get<Index>();
+}
+
+// the sections the chain would run, in the same order, so that a sample can go through all of them at once
+static int getActiveSections(PrecisionMonoChain& monoChain, std::array<PrecisionFilter*, 9>& sections) {
+    int numSections = 0;
+    if (!monoChain.isBypassed<ChainPositions::LowCut>()) {
+        auto& lowCut = monoChain.get<ChainPositions::LowCut>();
+        addActiveCutStage<0>(lowCut, sections, numSections);
+        addActiveCutStage<1>(lowCut, sections, numSections);
+        addActiveCutStage<2>(lowCut, sections, numSections);
+        addActiveCutStage<3>(lowCut, sections, numSections);
+    }
+    if (!monoChain.isBypassed<ChainPositions::Peak>())
+        sections[(size_t)numSections++] = &monoChain.get<ChainPositions::Peak>();
+    if (!monoChain.isBypassed<ChainPositions::HighCut>()) {
+        auto& highCut = monoChain.get<ChainPositions::HighCut>();
+        addActiveCutStage<0>(highCut, sections, numSections);
+        addActiveCutStage<1>(highCut, sections, numSections);
+        addActiveCutStage<2>(highCut, sections, numSections);
+        addActiveCutStage<3>(highCut, sections, numSections);
+    }
+    return numSections;
+}
+
+void FilterModuleDSP::applyLatestDesign()
+{
+    if ((middleDesign.load() & newDesignFlag) == 0) {
+        return;
+    }
+    frontDesign = middleDesign.exchange(frontDesign) & 3;
+    for (auto& chain : chains)
+        applyDesignToChain(chain, designs[frontDesign]);
+}
+
 void FilterModuleDSP::addParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout)
 {
     for (int i = 1; i < 9; ++i) {
@@ -152,15 +357,16 @@ void FilterModuleDSP::addParameters(juce::AudioProcessorValueTreeState::Paramete
         layout.add(std::move(highCutGroup));
         layout.add(std::move(peakGroup));
 
+        addStereoModeParameter(layout, "Filter", i);
         layout.add(std::make_unique<AudioParameterBool>("Filter Bypassed " + std::to_string(i), "Filter Bypassed " + std::to_string(i), false, "Filter " + std::to_string(i)));
         layout.add(std::make_unique<AudioParameterBool>("Filter Analyzer Enabled " + std::to_string(i), "Filter Analyzer Enabled " + std::to_string(i), true, "Filter " + std::to_string(i)));
     }
 
 }
 
-MonoChain* FilterModuleDSP::getOneChain()
+PrecisionMonoChain* FilterModuleDSP::getOneChain()
 {
-    return &leftChain;
+    return chains.empty() ? nullptr : &chains.front();
 }
 
 void FilterModuleDSP::setModuleType()
@@ -168,48 +374,48 @@ void FilterModuleDSP::setModuleType()
     moduleType = ModuleType::IIRFilter;
 }
 
-void FilterModuleDSP::updateDSPState(double sampleRate) {
-    auto settings = getSettings(apvts, getChainPosition());
-
-    bypassed = settings.bypassed;
-    updateLowCutFilter(settings, sampleRate);
-    updatePeakFilter(settings, sampleRate);
-    updateHighCutFilter(settings, sampleRate);
+void FilterModuleDSP::updateDSPState(double) {
+    // coefficients are redesigned by the design thread only when the settings or the sample rate change
+    applyLatestDesign();
+
+    bypassed = parameterHandles.bypassed->load() > 0.5f;
+    setBypassFadeTarget(bypassed);
+    stereoMode = static_cast<StereoMode>(static_cast<int>(parameterHandles.stereoMode->load()));
+    // the handle is named after the settings field, but the parameter is "Filter Analyzer Enabled"
+    analyzerEnabled = parameterHandles.analyzerBypassed->load() > 0.5f;
+    // the sections keep filtering while the bypass fades
+    const auto sectionsBypassed = isFullyBypassed();
+    for (auto& chain : chains) {
+        chain.setBypassed<ChainPositions::LowCut>(sectionsBypassed);
+        chain.setBypassed<ChainPositions::Peak>(sectionsBypassed);
+        chain.setBypassed<ChainPositions::HighCut>(sectionsBypassed);
+    }
 }
 
-void FilterModuleDSP::updatePeakFilter(const FilterChainSettings& chainSettings, double sampleRate) {
-    auto peakCoefficients = makePeakFilter(chainSettings, sampleRate);
-    // JUCE allocates coefficients on the HEAP
-    updateCoefficients(leftChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
-    updateCoefficients(rightChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
-
-    leftChain.setBypassed<ChainPositions::Peak>(chainSettings.bypassed);
-    rightChain.setBypassed<ChainPositions::Peak>(chainSettings.bypassed);
+int FilterModuleDSP::getTailSamples()
+{
+    return isFullyBypassed() ? 0 : designs[frontDesign].tailSamples;
 }
 
-void FilterModuleDSP::updateLowCutFilter(const FilterChainSettings& chainSettings, double sampleRate) {
-    auto lowCutCoefficients = makeLowCutFilter(chainSettings, sampleRate);
-    auto& leftLowCut = leftChain.get<ChainPositions::LowCut>();
-    updateCutFilter(leftLowCut, lowCutCoefficients, static_cast<FilterSlope>(chainSettings.lowCutSlope));
-    auto& rightLowCut = rightChain.get<ChainPositions::LowCut>();
-    updateCutFilter(rightLowCut, lowCutCoefficients, static_cast<FilterSlope>(chainSettings.lowCutSlope));
-
-    leftChain.setBypassed<ChainPositions::LowCut>(chainSettings.bypassed);
-    rightChain.setBypassed<ChainPositions::LowCut>(chainSettings.bypassed);
+bool FilterModuleDSP::isIdle() noexcept
+{
+    // the chain keeps the filter active anyway while its analyzer is showing
+    return parameterHandles.bypassed->load() > 0.5f && isFullyBypassed();
 }
 
-void FilterModuleDSP::updateHighCutFilter(const FilterChainSettings& chainSettings, double sampleRate) {
-    auto highCutCoefficients = makeHighCutFilter(chainSettings, sampleRate);
-    auto& leftHighCut = leftChain.get<ChainPositions::HighCut>();
-    updateCutFilter(leftHighCut, highCutCoefficients, static_cast<FilterSlope>(chainSettings.highCutSlope));
-    auto& rightHighCut = rightChain.get<ChainPositions::HighCut>();
-    updateCutFilter(rightHighCut, highCutCoefficients, static_cast<FilterSlope>(chainSettings.highCutSlope));
+void FilterModuleDSP::resetChannelState() noexcept
+{
+    DSPModule::resetChannelState();
+    for (auto& chain : chains)
+        chain.reset();
+}
 
-    leftChain.setBypassed<ChainPositions::HighCut>(chainSettings.bypassed);
-    rightChain.setBypassed<ChainPositions::HighCut>(chainSettings.bypassed);
+bool FilterModuleDSP::isAnalyzerEnabled() const
+{
+    return analyzerEnabled;
 }
 
-void FilterModuleDSP::prepareToPlay(double sampleRate, int samplesPerBlock)
+void FilterModuleDSP::prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels)
 {
     juce::dsp::ProcessSpec spec;
 
@@ -217,27 +423,71 @@ void FilterModuleDSP::prepareToPlay(double sampleRate, int samplesPerBlock)
     spec.numChannels = 1;
     spec.sampleRate = sampleRate;
 
-    leftChain.prepare(spec);
-    rightChain.prepare(spec);
+    // the new chains get the current design, a newer one is applied to all of them below
+    chains.resize((size_t)numChannels);
+    for (auto& chain : chains)
+        applyDesignToChain(chain, designs[frontDesign]);
+
+    // first design done synchronously
+    designSampleRate = sampleRate;
+    {
+        const juce::ScopedLock lock(designLock);
+        designCoefficients();
+    }
+    // before prepare, so that the filter states are allocated for the designed order
+    applyLatestDesign();
+
+    for (auto& chain : chains)
+        chain.prepare(spec);
 
+    // before updateDSPState, so that the sections follow the bypass right away
+    prepareBypassFade(sampleRate, parameterHandles.bypassed->load() > 0.5f);
     updateDSPState(sampleRate);
 }
 
 void FilterModuleDSP::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, double sampleRate)
 {
     updateDSPState(sampleRate);
+    // the bypassed chains wouldn't touch the samples
+    if (isFullyBypassed()) {
+        return;
+    }
 
-    juce::dsp::AudioBlock<float> block(buffer);
-    auto leftBlock = block.getSingleChannelBlock(0);
-    auto rightBlock = block.getSingleChannelBlock(1);
-
-    juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
-    juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
-
-    leftChain.process(leftContext);
-    rightChain.process(rightContext);
+    const auto numSamples = buffer.getNumSamples();
+    const auto numChannels = juce::jmin(buffer.getNumChannels(), (int)chains.size());
+    const float* processedGain = nullptr;
+    const float* dryGain = nullptr;
+    const auto fading = getBypassFade(numSamples, processedGain, dryGain);
+    std::array<PrecisionFilter*, 9> sections;
+    for (auto channel = 0; channel < numChannels; ++channel) {
+        auto* data = buffer.getWritePointer(channel);
+        // every sample goes through all the sections in double precision, converted on the way in and out:
+        // no conversion pass of its own and no double buffer
+        const auto numSections = getActiveSections(chains[(size_t)channel], sections);
+        if (fading) {
+            // equal-power crossfade with the input, still in data
+            for (auto i = 0; i < numSamples; ++i) {
+                double sample = data[i];
+                for (auto s = 0; s < numSections; ++s)
+                    sample = sections[(size_t)s]->processSample(sample);
+                data[i] = (float)sample * processedGain[i] + data[i] * dryGain[i];
+            }
+        }
+        else {
+            for (auto i = 0; i < numSamples; ++i) {
+                double sample = data[i];
+                for (auto s = 0; s < numSections; ++s)
+                    sample = sections[(size_t)s]->processSample(sample);
+                data[i] = (float)sample;
+            }
+        }
+        // like the block processing of the filters
+        for (auto s = 0; s < numSections; ++s)
+            sections[(size_t)s]->snapToZero();
+    }
 }
 
+
 //==============================================================================
 
 /* FilterModule GUI */
@@ -286,6 +536,8 @@ FilterModuleGUI::FilterModuleGUI(BiztortionAudioProcessor& p, unsigned int chain
     highCutSlopeSlider.labels.add({ 0.0f, "12" });
     highCutSlopeSlider.labels.add({ 1.f, "48" });
 
+    stereoModeBoxAttachment = attachStereoModeBox(stereoModeBox, audioProcessor.apvts, "Filter Stereo Mode " + std::to_string(chainPosition));
+
     // buttons
 
     bypassButton.setLookAndFeel(&lnf);
@@ -349,6 +601,7 @@ std::vector<juce::Component*> FilterModuleGUI::getAllComps()
         &highCutFreqSlider,
         &lowCutSlopeSlider,
         &highCutSlopeSlider,
+        &stereoModeBox,
         // responseCurve
         &filterFftAnalyzerComponent,
         &responseCurveComponent,
@@ -367,7 +620,8 @@ std::vector<juce::Component*> FilterModuleGUI::getParamComps()
         &lowCutFreqSlider,
         &highCutFreqSlider,
         &lowCutSlopeSlider,
-        &highCutSlopeSlider
+        &highCutSlopeSlider,
+        &stereoModeBox
     };
 }
 
@@ -383,6 +637,7 @@ void FilterModuleGUI::updateParameters(const juce::Array<juce::var>& values)
     lowCutSlopeSlider.setValue(*(value++), juce::NotificationType::sendNotificationSync);
     highCutSlopeSlider.setValue(*(value++), juce::NotificationType::sendNotificationSync);
     analyzerButton.setToggleState(*(value++), juce::NotificationType::sendNotificationSync);
+    stereoModeBox.setSelectedItemIndex(*(value++), juce::NotificationType::sendNotificationSync);
 }
 
 void FilterModuleGUI::resetParameters(unsigned int chainPosition)
@@ -396,6 +651,7 @@ void FilterModuleGUI::resetParameters(unsigned int chainPosition)
     auto highcutSlope = audioProcessor.apvts.getParameter("HighCut Slope " + std::to_string(chainPosition));
     auto bypassed = audioProcessor.apvts.getParameter("Filter Bypassed " + std::to_string(chainPosition));
     auto analyzerEnabled = audioProcessor.apvts.getParameter("Filter Analyzer Enabled " + std::to_string(chainPosition));
+    auto stereoMode = audioProcessor.apvts.getParameter("Filter Stereo Mode " + std::to_string(chainPosition));
 
     peakFreq->setValueNotifyingHost(peakFreq->getDefaultValue());
     peakGain->setValueNotifyingHost(peakGain->getDefaultValue());
@@ -406,6 +662,7 @@ void FilterModuleGUI::resetParameters(unsigned int chainPosition)
     highcutSlope->setValueNotifyingHost(highcutSlope->getDefaultValue());
     bypassed->setValueNotifyingHost(bypassed->getDefaultValue());
     analyzerEnabled->setValueNotifyingHost(analyzerEnabled->getDefaultValue());
+    stereoMode->setValueNotifyingHost(stereoMode->getDefaultValue());
 }
 
 juce::Array<juce::var> FilterModuleGUI::getParamValues()
@@ -421,6 +678,7 @@ juce::Array<juce::var> FilterModuleGUI::getParamValues()
     values.add(juce::var(lowCutSlopeSlider.getValue()));
     values.add(juce::var(highCutSlopeSlider.getValue()));
     values.add(juce::var(analyzerButton.getToggleState()));
+    values.add(juce::var(stereoModeBox.getSelectedItemIndex()));
 
     return values;
 }
@@ -484,6 +742,10 @@ void FilterModuleGUI::resized()
     title.setBounds(titleAndBypassArea);
     title.setJustificationType(juce::Justification::centredBottom);
 
+    // stereo mode on the right of the title
+    auto stereoModeArea = titleAndBypassArea;
+    stereoModeBox.setBounds(stereoModeArea.removeFromRight(100).reduced(4, 3));
+
     // fft analyzer & response curve
 
     filterFftAnalyzerComponent.setBounds(responseCurveArea);
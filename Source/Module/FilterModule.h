@@ -64,9 +64,20 @@ struct FilterChainSettings {
     float peakFreq{ 0 }, peakGainInDecibels{ 0 }, peakQuality{ 1.f };
     float lowCutFreq{ 0 }, highCutFreq{ 0 };
     int lowCutSlope{ FilterSlope::Slope_12 }, highCutSlope{ FilterSlope::Slope_12 };
+    // StereoMode
+    int stereoMode{ 0 };
     bool bypassed{ false }, analyzerBypassed{ false };
 };
 
+// APVTS parameters of one Filter chain slot
+struct FilterParameterHandles {
+    std::atomic<float>* peakFreq{ nullptr }, * peakGainInDecibels{ nullptr }, * peakQuality{ nullptr };
+    std::atomic<float>* lowCutFreq{ nullptr }, * highCutFreq{ nullptr };
+    std::atomic<float>* lowCutSlope{ nullptr }, * highCutSlope{ nullptr };
+    std::atomic<float>* stereoMode{ nullptr };
+    std::atomic<float>* bypassed{ nullptr }, * analyzerBypassed{ nullptr };
+};
+
 using Filter = juce::dsp::IIR::Filter<float>;
 using CutFilter = juce::dsp::ProcessorChain<Filter, Filter, Filter, Filter>;
 using MonoChain = juce::dsp::ProcessorChain<CutFilter, Filter, CutFilter>;
@@ -80,6 +91,14 @@ enum ChainPositions {
 using Coefficients = Filter::CoefficientsPtr;
 void updateCoefficients(Coefficients& old, const Coefficients& replacements);
 
+// the audio path keeps filter states and coefficients in double precision (the float types above are for the GUI):
+// high Q peaks and cascaded Butterworth sections at low cutoffs stay accurate and stable
+using PrecisionFilter = juce::dsp::IIR::Filter<double>;
+using PrecisionCutFilter = juce::dsp::ProcessorChain<PrecisionFilter, PrecisionFilter, PrecisionFilter, PrecisionFilter>;
+using PrecisionMonoChain = juce::dsp::ProcessorChain<PrecisionCutFilter, PrecisionFilter, PrecisionCutFilter>;
+using PrecisionCoefficients = PrecisionFilter::CoefficientsPtr;
+void updateCoefficients(PrecisionCoefficients& old, const PrecisionCoefficients& replacements);
+
 template<typename ChainType, typename CoefficientType>
 void updateCutFilter(ChainType& monoChain, const CoefficientType& cutCoefficients, const FilterSlope& slope) {
     monoChain. template setBypassed<0>(true);
@@ -118,41 +137,101 @@ void updateCutFilter(ChainType& monoChain, const CoefficientType& cutCoefficient
     }
 }
 
-class FilterModuleDSP : public DSPModule {
+// shared by every FilterModuleDSP: designs the filter coefficients away from the audio thread
+class FilterDesignThread : public juce::TimeSliceThread {
+public:
+    FilterDesignThread();
+    ~FilterDesignThread() override;
+};
+
+// a complete set of coefficients (values are written in place, the objects are allocated once)
+struct FilterDesign {
+    FilterDesign();
+
+    std::array<PrecisionCoefficients, 4> lowCut, highCut;
+    PrecisionCoefficients peak;
+    int lowCutSlope{ FilterSlope::Slope_12 }, highCutSlope{ FilterSlope::Slope_12 };
+    // samples for the impulse response of the cascade to decay below DSPModule::silenceThreshold
+    int tailSamples{ 0 };
+};
+
+class FilterModuleDSP : public DSPModule, private juce::TimeSliceClient, private juce::AudioProcessorValueTreeState::Listener {
 public:
     FilterModuleDSP(juce::AudioProcessorValueTreeState& _apvts);
+    ~FilterModuleDSP() override;
     // inline for avoiding linking problems with functions which have declaration + impementation
     // in the file.h (placed here for convenience)
+    // SampleType: float for the GUI, double for the audio path
+    template <typename SampleType = float>
     static inline auto makeLowCutFilter(const FilterChainSettings& chainSettings, double sampleRate) {
         // i need explanation ...
-        return juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(
+        return juce::dsp::FilterDesign<SampleType>::designIIRHighpassHighOrderButterworthMethod(
             chainSettings.lowCutFreq, sampleRate, 2 * (chainSettings.lowCutSlope + 1));
     }
+    template <typename SampleType = float>
     static inline auto makeHighCutFilter(const FilterChainSettings& chainSettings, double sampleRate) {
         // i need explanation ...
-        return juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(
+        return juce::dsp::FilterDesign<SampleType>::designIIRLowpassHighOrderButterworthMethod(
             chainSettings.highCutFreq, sampleRate, 2 * (chainSettings.highCutSlope + 1));
     }
-    static Coefficients makePeakFilter(const FilterChainSettings& chainSettings, double sampleRate);
+    template <typename SampleType = float>
+    static inline typename juce::dsp::IIR::Coefficients<SampleType>::Ptr makePeakFilter(const FilterChainSettings& chainSettings, double sampleRate) {
+        return juce::dsp::IIR::Coefficients<SampleType>::makePeakFilter(sampleRate,
+            chainSettings.peakFreq, chainSettings.peakQuality,
+            juce::Decibels::decibelsToGain((SampleType)chainSettings.peakGainInDecibels));
+    }
 
     static FilterChainSettings getSettings(juce::AudioProcessorValueTreeState& apvts, unsigned int chainPosition);
+    static FilterChainSettings getSettings(const FilterParameterHandles& handles);
+    static FilterParameterHandles getParameterHandles(juce::AudioProcessorValueTreeState& apvts, unsigned int chainPosition);
 
     static void addParameters(juce::AudioProcessorValueTreeState::ParameterLayout&);
-    MonoChain* getOneChain();
+    PrecisionMonoChain* getOneChain();
+    // "Filter Analyzer Enabled" parameter, read once per block
+    bool isAnalyzerEnabled() const;
 
     void setModuleType() override;
 
     void updateDSPState(double sampleRate) override;
-    void updatePeakFilter(const FilterChainSettings& chainSettings, double sampleRate);
-    void updateLowCutFilter(const FilterChainSettings& chainSettings, double sampleRate);
-    void updateHighCutFilter(const FilterChainSettings& chainSettings, double sampleRate);
 
-    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels) override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&, double) override;
+    int getTailSamples() override;
+    bool isIdle() noexcept override;
+
+protected:
+    void cacheParameterHandles() override;
+    void resetChannelState() noexcept override;
 
 private:
-    MonoChain leftChain, rightChain;
+    // design thread side
+    int useTimeSlice() override;
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void designCoefficients();
+    // audio thread side
+    void applyLatestDesign();
+
+    FilterParameterHandles parameterHandles;
+    // one chain per channel
+    std::vector<PrecisionMonoChain> chains;
     bool bypassed = false;
+    bool analyzerEnabled = true;
+
+    juce::SharedResourcePointer<FilterDesignThread> designThread;
+    juce::StringArray listenedParameterIDs;
+    // serializes the writers (design thread and prepareToPlay), never taken by the audio thread
+    juce::CriticalSection designLock;
+    // bumped by every LowCut/HighCut/Peak parameter change, a redesign happens only when it moves
+    std::atomic<unsigned int> parameterGeneration{ 1 };
+    std::atomic<double> designSampleRate{ 0.0 };
+    unsigned int designedGeneration = 0;
+    double designedSampleRate = 0.0;
+    // lock-free triple buffer: the writer fills designs[backDesign], the audio thread
+    // reads designs[frontDesign] and they swap with middleDesign
+    static constexpr int newDesignFlag = 4;
+    std::array<FilterDesign, 3> designs;
+    std::atomic<int> middleDesign{ 1 };
+    int backDesign = 0, frontDesign = 2;
 };
 
 //==============================================================================
@@ -180,6 +259,7 @@ private:
     using APVTS = juce::AudioProcessorValueTreeState;
     using Attachment = APVTS::SliderAttachment;
     using ButtonAttachment = APVTS::ButtonAttachment;
+    using ComboBoxAttachment = APVTS::ComboBoxAttachment;
 
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
@@ -207,6 +287,9 @@ private:
     ButtonAttachment bypassButtonAttachment,
         analyzerButtonAttachment;
 
+    juce::ComboBox stereoModeBox;
+    std::unique_ptr<ComboBoxAttachment> stereoModeBoxAttachment;
+
     ButtonsLookAndFeel lnf;
     
     ResponseCurveComponent responseCurveComponent;
@@ -57,6 +57,22 @@ void GUIModule::handleParamCompsEnablement(bool bypass)
     }
 }
 
+std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> GUIModule::attachStereoModeBox(
+    juce::ComboBox& box, juce::AudioProcessorValueTreeState& apvts, const juce::String& parameterID)
+{
+    // the items must be there before the attachment selects the current one
+    if (auto* parameter = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter(parameterID))) {
+        box.addItemList(parameter->choices, 1);
+    }
+    box.setColour(juce::ComboBox::backgroundColourId, juce::Colours::darkgrey.withAlpha(0.75f));
+    box.setColour(juce::ComboBox::textColourId, juce::Colours::white);
+    box.setColour(juce::ComboBox::outlineColourId, juce::Colours::white);
+    box.setJustificationType(juce::Justification::centred);
+    box.setTooltip("Process left/right, or mid/side (mid only and side only leave the other lane untouched and save CPU)");
+
+    return std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(apvts, parameterID, box);
+}
+
 juce::Rectangle<int> GUIModule::getContainerArea()
 {
     // returns a dimesion reduced rectangle as bounds in order to avoid margin collisions
@@ -49,6 +49,11 @@ public:
     // get parameter values of this GUIModule (vars in the array can be bool or double values)
     virtual juce::Array<juce::var> getParamValues() = 0;
 
+protected:
+    // fills the stereo mode box of a processing slot with the choices of parameterID and attaches it
+    static std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> attachStereoModeBox(
+        juce::ComboBox& box, juce::AudioProcessorValueTreeState& apvts, const juce::String& parameterID);
+
 private:
     juce::Rectangle<int> getContainerArea();
 };
\ No newline at end of file
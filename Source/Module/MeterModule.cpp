@@ -39,6 +39,7 @@ along with Biztortion. If not, see < http://www.gnu.org/licenses/>.
 MeterModuleDSP::MeterModuleDSP(juce::AudioProcessorValueTreeState& _apvts, juce::String _type)
     : DSPModule(_apvts), type(_type) {
     setChainPosition(type == "Input" ? 0 : 9);
+    setModuleType();
 }
 
 juce::String MeterModuleDSP::getType()
@@ -47,14 +48,33 @@ juce::String MeterModuleDSP::getType()
 }
 
 MeterSettings MeterModuleDSP::getSettings(juce::AudioProcessorValueTreeState& apvts, juce::String type)
+{
+    return getSettings(getParameterHandles(apvts, type));
+}
+
+MeterSettings MeterModuleDSP::getSettings(const MeterParameterHandles& handles)
 {
     MeterSettings settings;
-    juce::String search = type + " Meter Level";
-    settings.levelInDecibel = apvts.getRawParameterValue(search)->load();
+    settings.levelInDecibel = handles.levelInDecibel->load();
 
     return settings;
 }
 
+MeterParameterHandles MeterModuleDSP::getParameterHandles(juce::AudioProcessorValueTreeState& apvts, juce::String type)
+{
+    MeterParameterHandles handles;
+    juce::String search = type + " Meter Level";
+    handles.levelInDecibel = apvts.getRawParameterValue(search);
+
+    return handles;
+}
+
+void MeterModuleDSP::cacheParameterHandles()
+{
+    // the meter parameters depend on the type, not on the chain position
+    parameterHandles = getParameterHandles(apvts, type);
+}
+
 void MeterModuleDSP::addParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout)
 {
     layout.add(std::move(std::make_unique<juce::AudioParameterFloat>("Input Meter Level", "Input Meter Level", juce::NormalisableRange<float>(-60.f, 10.f, 0.5f), 0.f, "Input Meter")));
@@ -73,21 +93,22 @@ void MeterModuleDSP::setModuleType()
 
 void MeterModuleDSP::updateDSPState(double)
 {
-    auto settings = getSettings(apvts, type);
+    auto settings = getSettings(parameterHandles);
     level.setGainDecibels(settings.levelInDecibel);
 }
 
-void MeterModuleDSP::prepareToPlay(double sampleRate, int samplesPerBlock)
+void MeterModuleDSP::prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels)
 {
     juce::dsp::ProcessSpec spec;
 
     spec.maximumBlockSize = samplesPerBlock;
-    spec.numChannels = 2;
+    spec.numChannels = numChannels;
     spec.sampleRate = sampleRate;
 
     level.prepare(spec);
 
-    meterSource.resize(2, sampleRate * 0.1 / samplesPerBlock);
+    // one meter bar per channel
+    meterSource.resize(numChannels, sampleRate * 0.1 / samplesPerBlock);
 }
 
 void MeterModuleDSP::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&, double sampleRate)
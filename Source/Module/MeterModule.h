@@ -46,22 +46,33 @@ struct MeterSettings {
     float levelInDecibel{ 0 };
 };
 
+// APVTS parameters of the Input or Output meter
+struct MeterParameterHandles {
+    std::atomic<float>* levelInDecibel{ nullptr };
+};
+
 class MeterModuleDSP : public DSPModule {
 public:
     MeterModuleDSP(juce::AudioProcessorValueTreeState& _apvts, juce::String _type);
 
     juce::String getType();
     static MeterSettings getSettings(juce::AudioProcessorValueTreeState& apvts, juce::String type);
+    static MeterSettings getSettings(const MeterParameterHandles& handles);
+    static MeterParameterHandles getParameterHandles(juce::AudioProcessorValueTreeState& apvts, juce::String type);
     static void addParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout);
     foleys::LevelMeterSource& getMeterSource();
 
     void setModuleType() override;
 
     void updateDSPState(double sampleRate) override;
-    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels) override;
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, double sampleRate) override;
 
+protected:
+    void cacheParameterHandles() override;
+
 private:
+    MeterParameterHandles parameterHandles;
     juce::String type;
     juce::dsp::Gain<float> level;
 
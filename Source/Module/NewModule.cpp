@@ -150,7 +150,7 @@ void NewModuleGUI::setModuleType(ModuleType mt)
 
 void NewModuleGUI::addNewModule(ModuleType type)
 {
-    audioProcessor.addAndSetupModuleForDSP(audioProcessor.createDSPModule(type), getChainPosition());
+    audioProcessor.addAndSetupModuleForDSP(type, getChainPosition());
     audioProcessor.addDSPmoduleTypeAndPositionToAPVTS(type, getChainPosition());
     addModuleToGUI(editor.createGUIModule(type, getChainPosition()));
     newModuleSetup(type);
@@ -359,12 +359,15 @@ void NewModuleGUI::itemDropped(const SourceDetails& dragSourceDetails)
     auto cp = component->getChainPosition();
     auto thisModuleType = moduleType;
     bool oneModuleIsAllocatedHere = getModuleType() != ModuleType::Uninstantiated;
+    // the whole swap reaches the audio thread as one chain snapshot, once the parameters have been moved:
+    // the new modules are prepared with their final parameters and fade in
+    BiztortionAudioProcessor::ScopedChainEdit chainEdit(audioProcessor);
     // add newPosition DSPModule
-    audioProcessor.addAndSetupModuleForDSP(audioProcessor.createDSPModule(type), getChainPosition());
+    audioProcessor.addAndSetupModuleForDSP(type, getChainPosition());
     audioProcessor.addDSPmoduleTypeAndPositionToAPVTS(type, getChainPosition());
     if (oneModuleIsAllocatedHere) {
         // add oldPosition DSPModule
-        audioProcessor.addAndSetupModuleForDSP(audioProcessor.createDSPModule(getModuleType()), cp);
+        audioProcessor.addAndSetupModuleForDSP(getModuleType(), cp);
         audioProcessor.addDSPmoduleTypeAndPositionToAPVTS(getModuleType(), cp);
     }
     // setup NewModuleGUIs
@@ -53,16 +53,52 @@ drow::AudioOscilloscope* OscilloscopeModuleDSP::getRightOscilloscope()
     return &rightOscilloscope;
 }
 
+void OscilloscopeModuleDSP::arm()
+{
+    ++watchers;
+}
+
+void OscilloscopeModuleDSP::disarm()
+{
+    jassert(watchers.load() > 0);
+    --watchers;
+}
+
+bool OscilloscopeModuleDSP::isIdle() noexcept
+{
+    return parameterHandles.bypassed->load() > 0.5f || !isArmed();
+}
+
 OscilloscopeSettings OscilloscopeModuleDSP::getSettings(juce::AudioProcessorValueTreeState& apvts, unsigned int chainPosition)
+{
+    return getSettings(getParameterHandles(apvts, chainPosition));
+}
+
+OscilloscopeSettings OscilloscopeModuleDSP::getSettings(const OscilloscopeParameterHandles& handles)
 {
     OscilloscopeSettings settings;
-    settings.hZoom = apvts.getRawParameterValue("Oscilloscope H Zoom " + std::to_string(chainPosition))->load();
-    settings.vZoom = apvts.getRawParameterValue("Oscilloscope V Zoom " + std::to_string(chainPosition))->load();
-    settings.bypassed = apvts.getRawParameterValue("Oscilloscope Bypassed " + std::to_string(chainPosition))->load() > 0.5f;
+    settings.hZoom = handles.hZoom->load();
+    settings.vZoom = handles.vZoom->load();
+    settings.bypassed = handles.bypassed->load() > 0.5f;
 
     return settings;
 }
 
+OscilloscopeParameterHandles OscilloscopeModuleDSP::getParameterHandles(juce::AudioProcessorValueTreeState& apvts, unsigned int chainPosition)
+{
+    OscilloscopeParameterHandles handles;
+    handles.hZoom = apvts.getRawParameterValue("Oscilloscope H Zoom " + std::to_string(chainPosition));
+    handles.vZoom = apvts.getRawParameterValue("Oscilloscope V Zoom " + std::to_string(chainPosition));
+    handles.bypassed = apvts.getRawParameterValue("Oscilloscope Bypassed " + std::to_string(chainPosition));
+
+    return handles;
+}
+
+void OscilloscopeModuleDSP::cacheParameterHandles()
+{
+    parameterHandles = getParameterHandles(apvts, getChainPosition());
+}
+
 void OscilloscopeModuleDSP::addParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout)
 {
     for (int i = 1; i < 9; ++i) {
@@ -85,7 +121,7 @@ void OscilloscopeModuleDSP::setModuleType()
 
 void OscilloscopeModuleDSP::updateDSPState(double sampleRate)
 {
-    auto settings = getSettings(apvts, getChainPosition());
+    auto settings = getSettings(parameterHandles);
     bypassed = settings.bypassed;
     leftOscilloscope.setHorizontalZoom(settings.hZoom);
     leftOscilloscope.setVerticalZoom(settings.vZoom);
@@ -93,7 +129,7 @@ void OscilloscopeModuleDSP::updateDSPState(double sampleRate)
     rightOscilloscope.setVerticalZoom(settings.vZoom);
 }
 
-void OscilloscopeModuleDSP::prepareToPlay(double sampleRate, int samplesPerBlock)
+void OscilloscopeModuleDSP::prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels)
 {
     leftOscilloscope.clear();
     rightOscilloscope.clear();
@@ -104,8 +140,9 @@ void OscilloscopeModuleDSP::processBlock(juce::AudioBuffer<float>& buffer, juce:
 {
     updateDSPState(sampleRate);
     if (!bypassed) {
+        // the first two channels, a mono signal is shown on both
         leftOscilloscope.processBlock(buffer.getReadPointer(0), buffer.getNumSamples());
-        rightOscilloscope.processBlock(buffer.getReadPointer(1), buffer.getNumSamples());
+        rightOscilloscope.processBlock(buffer.getReadPointer(juce::jmin(1, buffer.getNumChannels() - 1)), buffer.getNumSamples());
     }
 }
 
@@ -115,8 +152,9 @@ void OscilloscopeModuleDSP::processBlock(juce::AudioBuffer<float>& buffer, juce:
 
 //==============================================================================
 
-OscilloscopeModuleGUI::OscilloscopeModuleGUI(BiztortionAudioProcessor& p, drow::AudioOscilloscope* _leftOscilloscope, drow::AudioOscilloscope* _rightOscilloscope, unsigned int chainPosition)
-    : GUIModule(), audioProcessor(p), leftOscilloscope(_leftOscilloscope), rightOscilloscope(_rightOscilloscope),
+OscilloscopeModuleGUI::OscilloscopeModuleGUI(BiztortionAudioProcessor& p, OscilloscopeModuleDSP* _oscilloscopeModule, unsigned int chainPosition)
+    : GUIModule(), audioProcessor(p), oscilloscopeModule(_oscilloscopeModule),
+    leftOscilloscope(_oscilloscopeModule->getLeftOscilloscope()), rightOscilloscope(_oscilloscopeModule->getRightOscilloscope()),
     hZoomSlider(*audioProcessor.apvts.getParameter("Oscilloscope H Zoom " + std::to_string(chainPosition)), ""),
     vZoomSlider(*audioProcessor.apvts.getParameter("Oscilloscope V Zoom " + std::to_string(chainPosition)), ""),
     hZoomSliderAttachment(audioProcessor.apvts, "Oscilloscope H Zoom " + std::to_string(chainPosition), hZoomSlider),
@@ -175,6 +213,7 @@ OscilloscopeModuleGUI::OscilloscopeModuleGUI(BiztortionAudioProcessor& p, drow::
                 comp->leftOscilloscope->startTimerHz(59);
                 comp->rightOscilloscope->startTimerHz(59);
             }
+            comp->setScopesArmed(!freeze);
             
         }
     };
@@ -189,6 +228,7 @@ OscilloscopeModuleGUI::OscilloscopeModuleGUI(BiztortionAudioProcessor& p, drow::
         leftOscilloscope->startTimerHz(59);
     if(!rightOscilloscope->isTimerRunning())
         rightOscilloscope->startTimerHz(59);
+    setScopesArmed(true);
 
     for (auto* comp : getAllComps())
     {
@@ -200,6 +240,7 @@ OscilloscopeModuleGUI::OscilloscopeModuleGUI(BiztortionAudioProcessor& p, drow::
 
 OscilloscopeModuleGUI::~OscilloscopeModuleGUI()
 {
+    setScopesArmed(false);
     if (leftOscilloscope && leftOscilloscope->isTimerRunning()) {
         leftOscilloscope->stopTimer();
     }
@@ -212,6 +253,18 @@ OscilloscopeModuleGUI::~OscilloscopeModuleGUI()
     bypassButton.setLookAndFeel(nullptr);
 }
 
+void OscilloscopeModuleGUI::setScopesArmed(bool shouldBeArmed)
+{
+    if (shouldBeArmed == scopesArmed)
+        return;
+
+    scopesArmed = shouldBeArmed;
+    if (scopesArmed)
+        oscilloscopeModule->arm();
+    else
+        oscilloscopeModule->disarm();
+}
+
 std::vector<juce::Component*> OscilloscopeModuleGUI::getAllComps()
 {
     return {
@@ -48,26 +48,46 @@ struct OscilloscopeSettings {
     bool bypassed{ false };
 };
 
+// APVTS parameters of one Oscilloscope chain slot
+struct OscilloscopeParameterHandles {
+    std::atomic<float>* hZoom{ nullptr };
+    std::atomic<float>* vZoom{ nullptr };
+    std::atomic<float>* bypassed{ nullptr };
+};
+
 class OscilloscopeModuleDSP : public DSPModule {
 public:
     OscilloscopeModuleDSP(juce::AudioProcessorValueTreeState& _apvts);
 
     drow::AudioOscilloscope* getLeftOscilloscope();
     drow::AudioOscilloscope* getRightOscilloscope();
+    // the audio thread feeds the scopes only while at least one GUI (showing and not frozen) is watching them
+    bool isArmed() const { return watchers.load(std::memory_order_relaxed) > 0; }
+    // GUI thread
+    void arm();
+    void disarm();
 
     static OscilloscopeSettings getSettings(juce::AudioProcessorValueTreeState& apvts, unsigned int chainPosition);
+    static OscilloscopeSettings getSettings(const OscilloscopeParameterHandles& handles);
+    static OscilloscopeParameterHandles getParameterHandles(juce::AudioProcessorValueTreeState& apvts, unsigned int chainPosition);
     static void addParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout);
 
     void setModuleType() override;
 
     void updateDSPState(double sampleRate) override;
-    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels) override;
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, double sampleRate) override;
+    bool isIdle() noexcept override;
+
+protected:
+    void cacheParameterHandles() override;
 
 private:
+    OscilloscopeParameterHandles parameterHandles;
     bool bypassed = false;
     drow::AudioOscilloscope leftOscilloscope;
     drow::AudioOscilloscope rightOscilloscope;
+    std::atomic<int> watchers{ 0 };
 };
 
 //==============================================================================
@@ -78,7 +98,7 @@ private:
 
 class OscilloscopeModuleGUI : public GUIModule {
 public:
-    OscilloscopeModuleGUI(BiztortionAudioProcessor& p, drow::AudioOscilloscope* _leftOscilloscope, drow::AudioOscilloscope* _rightOscilloscope, unsigned int chainPosition);
+    OscilloscopeModuleGUI(BiztortionAudioProcessor& p, OscilloscopeModuleDSP* _oscilloscopeModule, unsigned int chainPosition);
     ~OscilloscopeModuleGUI();
 
     std::vector<juce::Component*> getAllComps() override;
@@ -117,6 +137,11 @@ private:
     ButtonsLookAndFeel lnf;
     ModuleLookAndFeel freezeLnf;
 
+    // the scopes are fed only while this GUI exists and isn't frozen
+    void setScopesArmed(bool shouldBeArmed);
+
+    OscilloscopeModuleDSP* oscilloscopeModule;
+    bool scopesArmed = false;
     drow::AudioOscilloscope* leftOscilloscope;
     drow::AudioOscilloscope* rightOscilloscope;
 };
\ No newline at end of file
@@ -59,9 +59,11 @@ void SlewLimiterModuleDSP::setModuleType()
 
 void SlewLimiterModuleDSP::updateDSPState(double sampleRate)
 {
-    auto settings = getSettings(apvts, getChainPosition());
+    auto settings = getSettings(parameterHandles);
 
     bypassed = settings.bypassed;
+    setBypassFadeTarget(bypassed);
+    stereoMode = static_cast<StereoMode>(settings.stereoMode);
 
     auto mix = settings.mix * 0.01f;
     dryGain.setTargetValue(1.f - mix);
@@ -75,7 +77,7 @@ void SlewLimiterModuleDSP::updateDSPState(double sampleRate)
     DCoffsetRemoveEnabled = settings.DCoffsetRemove;
 }
 
-void SlewLimiterModuleDSP::prepareToPlay(double sampleRate, int samplesPerBlock)
+void SlewLimiterModuleDSP::prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels)
 {
     juce::dsp::ProcessSpec spec;
 
@@ -83,101 +85,148 @@ void SlewLimiterModuleDSP::prepareToPlay(double sampleRate, int samplesPerBlock)
     spec.numChannels = 1;
     spec.sampleRate = sampleRate;
 
-    leftDCoffsetRemoveHPF.prepare(spec);
-    rightDCoffsetRemoveHPF.prepare(spec);
-
     // create a 1pole HPF at 5Hz in order to remove DC offset
+    DCoffsetRemoveHPFs.resize((size_t)numChannels);
     auto filterCoefficients = juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(5, sampleRate, 1);
-    updateCoefficients(leftDCoffsetRemoveHPF.coefficients, filterCoefficients[0]);
-    updateCoefficients(rightDCoffsetRemoveHPF.coefficients, filterCoefficients[0]);
+    for (auto& filter : DCoffsetRemoveHPFs) {
+        filter.prepare(spec);
+        updateCoefficients(filter.coefficients, filterCoefficients[0]);
+    }
+    // one pole at radius |a1|: samples for its impulse response to decay below silenceThreshold
+    auto poleRadius = (double)std::abs(filterCoefficients[0]->coefficients[2]);
+    DCoffsetRemoveTailSamples = poleRadius > 0.0 ? (int)std::ceil(std::log((double)silenceThreshold) / std::log(poleRadius)) : 0;
+    maxTailSamples = (int)(10.0 * sampleRate);
 
     updateDSPState(sampleRate);
+    prepareBypassFade(sampleRate, bypassed);
+    // rise and fall are smoothed per sample, so automation doesn't step once per block
+    rise.reset(sampleRate, 0.05);
+    fall.reset(sampleRate, 0.05);
+    symmetry.reset(sampleRate, 0.05);
+    bias.reset(sampleRate, 0.05);
+
+    slopeScale = static_cast<float>(slewMax / sampleRate);
+    slopeRange = std::log(slewMin / slewMax);
+    riseSlopeTarget = -1.f;
+    fallSlopeTarget = -1.f;
+    lastOutput.assign((size_t)numChannels, 0.f);
+    settledSamples = 0;
+}
 
-    wetBuffer.setSize(2, samplesPerBlock, false, true, true); // clears
-    tempBuffer.setSize(2, samplesPerBlock, false, true, true); // clears
+int SlewLimiterModuleDSP::getTailSamples()
+{
+    if (isFullyBypassed()) {
+        return 0;
+    }
+    // the output keeps slewing towards zero at the slowest of the two slopes once the input stops:
+    // worst case, from full scale (or further, if the drive took it there)
+    auto maxOutput = 1.f;
+    for (auto output : lastOutput) {
+        maxOutput = juce::jmax(maxOutput, std::abs(output));
+    }
+    auto slope = juce::jmin(riseSlope, fallSlope);
+    auto slewSamples = slope > 0.f ? juce::jmin((float)maxTailSamples, std::ceil(maxOutput / slope)) : 0.f;
+    return (int)slewSamples + (DCoffsetRemoveEnabled ? DCoffsetRemoveTailSamples : 0);
 }
 
-void SlewLimiterModuleDSP::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, double sampleRate)
+bool SlewLimiterModuleDSP::isIdle() noexcept
 {
+    return isDryOnly(parameterHandles.bypassed, parameterHandles.mix, wetGain);
+}
 
-    updateDSPState(sampleRate);
+void SlewLimiterModuleDSP::resetChannelState() noexcept
+{
+    DSPModule::resetChannelState();
+    for (auto& filter : DCoffsetRemoveHPFs)
+        filter.reset();
+    std::fill(lastOutput.begin(), lastOutput.end(), 0.f);
+}
 
-    if (!bypassed) {
+bool SlewLimiterModuleDSP::isTailSilent(int silentSamples)
+{
+    juce::ignoreUnused(silentSamples);
+    // the outputs have to reach zero first, they keep slewing for up to maxTailSamples after the input stops
+    return isFullyBypassed() || (settledSamples > 0 && settledSamples >= (DCoffsetRemoveEnabled ? DCoffsetRemoveTailSamples : 0));
+}
 
-        // SAFETY CHECK :::: since some hosts will change buffer sizes without calling prepToPlay (ex: Bitwig)
-        int numSamples = buffer.getNumSamples();
-        if (wetBuffer.getNumSamples() != numSamples)
-        {
-            wetBuffer.setSize(2, numSamples, false, true, true); // clears
-            tempBuffer.setSize(2, numSamples, false, true, true); // clears
-        }
+float SlewLimiterModuleDSP::getSlope(float normalizedValue) const noexcept
+{
+    // slewMax * Ts * (slewMin / slewMax) ^ normalizedValue
+    return slopeScale * std::exp(slopeRange * normalizedValue);
+}
 
-        // Wet Buffer feeding
-        for (auto channel = 0; channel < 2; channel++)
-            wetBuffer.copyFrom(channel, 0, buffer, channel, 0, numSamples);
+void SlewLimiterModuleDSP::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, double sampleRate)
+{
 
-        // Drive
-        driveGain.applyGain(wetBuffer, numSamples);
+    updateDSPState(sampleRate);
 
-        // Temp Buffer feeding for applying asymmetry
-        for (auto channel = 0; channel < 2; channel++)
-            tempBuffer.copyFrom(channel, 0, wetBuffer, channel, 0, numSamples);
+    if (!isFullyBypassed()) {
 
-        // internal variables
-        auto Ts = 1.f / sampleRate;
-        float slewRise = slewMax * Ts * std::pow(slewMin / slewMax, rise.getNextValue());
-        float slewFall = slewMax * Ts * std::pow(slewMin / slewMax, fall.getNextValue());
+        int numSamples = buffer.getNumSamples();
 
         // TODO : aggiungo MIX tra 2 diverse computazioni dei valori slewRise e slewFall per diversi effetti
 
-        // trying to compute slewRise/Fall values with different functions (exponential is the best)
-        //float slewRise = 0.000001f / rise.getNextValue();
-        //float slewFall = 0.000001f / fall.getNextValue();
-
-        // temporary variable to handle the last output at the end of the processing
-        float temp = lastOutput;
+        // slopes are recomputed per sample only while rise/fall are smoothing
+        auto smoothing = rise.isSmoothing() || fall.isSmoothing();
+        if (!smoothing) {
+            if (rise.getTargetValue() != riseSlopeTarget) {
+                riseSlopeTarget = rise.getTargetValue();
+                riseSlope = getSlope(riseSlopeTarget);
+            }
+            if (fall.getTargetValue() != fallSlopeTarget) {
+                fallSlopeTarget = fall.getTargetValue();
+                fallSlope = getSlope(fallSlopeTarget);
+            }
+        }
+        float slewRise = riseSlope;
+        float slewFall = fallSlope;
+
+        // parameters computed once per sample for all the channels
+        auto* drive = getRamp(driveGain, 0, numSamples);
+        auto* symmetryAmount = getRamp(symmetry, 1, numSamples);
+        auto* symmetryBias = getRamp(bias, 2, numSamples);
+        auto* dry = getRamp(dryGain, 3, numSamples);
+        auto* wet = getRamp(wetGain, 4, numSamples);
+        foldBypassFade(dry, wet, numSamples);
+        auto* riseRamp = getRamp(rise, 5, numSamples);
+        auto* fallRamp = getRamp(fall, 6, numSamples);
+        // slopes of the smoothing rise and fall, per sample
+        auto* slewRiseRamp = scratchArena->getRamp(7);
+        auto* slewFallRamp = scratchArena->getRamp(8);
+        for (auto i = 0; i < numSamples; ++i) {
+            slewRiseRamp[i] = smoothing ? getSlope(riseRamp[i]) : slewRise;
+            slewFallRamp[i] = smoothing ? getSlope(fallRamp[i]) : slewFall;
+        }
 
-        // Processing
-        for (auto channel = 0; channel < 2; ++channel)
-        {
-            auto* channelData = wetBuffer.getWritePointer(channel);
-            float output = lastOutput;
+        // fused kernel: drive -> slew limiting -> asymmetry -> DC offset removal -> mix in a single pass per channel,
+        // each channel with its own state.
+        // rise limiting: output + slewFall, fall limiting: output - slewRise (branch-free min/max pair)
+        const auto numChannels = juce::jmin(buffer.getNumChannels(), (int)lastOutput.size());
+        for (auto channel = 0; channel < numChannels; ++channel) {
+            auto* data = buffer.getWritePointer(channel);
+            auto& DCoffsetRemoveHPF = DCoffsetRemoveHPFs[(size_t)channel];
+            float output = lastOutput[(size_t)channel];
             for (auto i = 0; i < numSamples; ++i) {
+                auto driven = data[i] * drive[i];
+                output = jmin(jmax(driven, output - slewRiseRamp[i]), output + slewFallRamp[i]);
 
-                auto input = channelData[i];
-
-                // Rise limiting
-                if (input > output) {
-                    output = jmin(input, output + slewFall);
+                auto shaped = asymmetrySample(driven, output, symmetryAmount[i], symmetryBias[i]);
+                if (DCoffsetRemoveEnabled) {
+                    shaped = DCoffsetRemoveHPF.processSample(shaped);
                 }
-                // Fall limiting
-                else {
-                    output = jmax(input, output - slewRise);
-                }
-                channelData[i] = output;
+                data[i] = data[i] * dry[i] + shaped * wet[i];
+            }
+            lastOutput[(size_t)channel] = output;
+            if (DCoffsetRemoveEnabled) {
+                // processSample doesn't flush the filter state like process() does
+                DCoffsetRemoveHPF.snapToZero();
             }
-            temp = output;
         }
-        lastOutput = temp;
-
-        applyAsymmetry(tempBuffer, wetBuffer, symmetry.getNextValue(), bias.getNextValue(), numSamples);
-        
-        if (DCoffsetRemoveEnabled) {
-            juce::dsp::AudioBlock<float> block(tempBuffer);
-            auto leftBlock = block.getSingleChannelBlock(0);
-            auto rightBlock = block.getSingleChannelBlock(1);
-            juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
-            juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
-            leftDCoffsetRemoveHPF.process(leftContext);
-            rightDCoffsetRemoveHPF.process(rightContext);
+        auto settled = true;
+        for (auto output : lastOutput) {
+            settled = settled && std::abs(output) <= silenceThreshold;
         }
-
-        // Mixing buffers
-        dryGain.applyGain(buffer, numSamples);
-        wetGain.applyGain(tempBuffer, numSamples);
-
-        for (auto channel = 0; channel < 2; channel++)
-            buffer.addFrom(channel, 0, tempBuffer, channel, 0, numSamples);
+        settledSamples = settled ? juce::jmin(settledSamples, std::numeric_limits<int>::max() - numSamples) + numSamples : 0;
     }
 }
 
@@ -193,26 +242,55 @@ void SlewLimiterModuleDSP::addParameters(juce::AudioProcessorValueTreeState::Par
         layout.add(std::make_unique<AudioParameterFloat>("SlewLimiter Rise " + std::to_string(i), "SlewLimiter Rise " + std::to_string(i), NormalisableRange<float>(0.f, 100.f, 0.01f), 0.f, "SlewLimiter " + std::to_string(i)));
         layout.add(std::make_unique<AudioParameterFloat>("SlewLimiter Fall " + std::to_string(i), "SlewLimiter Fall " + std::to_string(i), NormalisableRange<float>(0.f, 100.f, 0.01f), 0.f, "SlewLimiter " + std::to_string(i)));
         layout.add(std::make_unique<AudioParameterBool>("SlewLimiter DCoffset Enabled " + std::to_string(i), "SlewLimiter DCoffset Enabled " + std::to_string(i), false, "SlewLimiter " + std::to_string(i)));
+        addStereoModeParameter(layout, "SlewLimiter", i);
         layout.add(std::make_unique<AudioParameterBool>("SlewLimiter Bypassed " + std::to_string(i), "SlewLimiter Bypassed " + std::to_string(i), false, "SlewLimiter " + std::to_string(i)));
     }
 }
 
 SlewLimiterSettings SlewLimiterModuleDSP::getSettings(juce::AudioProcessorValueTreeState& apvts, unsigned int chainPosition)
+{
+    return getSettings(getParameterHandles(apvts, chainPosition));
+}
+
+SlewLimiterSettings SlewLimiterModuleDSP::getSettings(const SlewLimiterParameterHandles& handles)
 {
     SlewLimiterSettings settings;
 
-    settings.drive = apvts.getRawParameterValue("SlewLimiter Drive " + std::to_string(chainPosition))->load();
-    settings.mix = apvts.getRawParameterValue("SlewLimiter Mix " + std::to_string(chainPosition))->load();
-    settings.symmetry = apvts.getRawParameterValue("SlewLimiter Symmetry " + std::to_string(chainPosition))->load();
-    settings.bias = apvts.getRawParameterValue("SlewLimiter Bias " + std::to_string(chainPosition))->load();
-    settings.rise = apvts.getRawParameterValue("SlewLimiter Rise " + std::to_string(chainPosition))->load();
-    settings.fall = apvts.getRawParameterValue("SlewLimiter Fall " + std::to_string(chainPosition))->load();
-    settings.DCoffsetRemove = apvts.getRawParameterValue("SlewLimiter DCoffset Enabled " + std::to_string(chainPosition))->load() > 0.5f;
-    settings.bypassed = apvts.getRawParameterValue("SlewLimiter Bypassed " + std::to_string(chainPosition))->load() > 0.5f;
+    settings.drive = handles.drive->load();
+    settings.mix = handles.mix->load();
+    settings.symmetry = handles.symmetry->load();
+    settings.bias = handles.bias->load();
+    settings.rise = handles.rise->load();
+    settings.fall = handles.fall->load();
+    settings.stereoMode = static_cast<int>(handles.stereoMode->load());
+    settings.DCoffsetRemove = handles.DCoffsetRemove->load() > 0.5f;
+    settings.bypassed = handles.bypassed->load() > 0.5f;
 
     return settings;
 }
 
+SlewLimiterParameterHandles SlewLimiterModuleDSP::getParameterHandles(juce::AudioProcessorValueTreeState& apvts, unsigned int chainPosition)
+{
+    SlewLimiterParameterHandles handles;
+
+    handles.drive = apvts.getRawParameterValue("SlewLimiter Drive " + std::to_string(chainPosition));
+    handles.mix = apvts.getRawParameterValue("SlewLimiter Mix " + std::to_string(chainPosition));
+    handles.symmetry = apvts.getRawParameterValue("SlewLimiter Symmetry " + std::to_string(chainPosition));
+    handles.bias = apvts.getRawParameterValue("SlewLimiter Bias " + std::to_string(chainPosition));
+    handles.rise = apvts.getRawParameterValue("SlewLimiter Rise " + std::to_string(chainPosition));
+    handles.fall = apvts.getRawParameterValue("SlewLimiter Fall " + std::to_string(chainPosition));
+    handles.stereoMode = apvts.getRawParameterValue("SlewLimiter Stereo Mode " + std::to_string(chainPosition));
+    handles.DCoffsetRemove = apvts.getRawParameterValue("SlewLimiter DCoffset Enabled " + std::to_string(chainPosition));
+    handles.bypassed = apvts.getRawParameterValue("SlewLimiter Bypassed " + std::to_string(chainPosition));
+
+    return handles;
+}
+
+void SlewLimiterModuleDSP::cacheParameterHandles()
+{
+    parameterHandles = getParameterHandles(apvts, getChainPosition());
+}
+
 //==============================================================================
 
 /* SlewLimiterModule GUI */
@@ -269,6 +347,8 @@ SlewLimiterModuleGUI::SlewLimiterModuleGUI(BiztortionAudioProcessor& p, unsigned
     slewLimiterFallSlider.labels.add({ 0.f, "0%" });
     slewLimiterFallSlider.labels.add({ 1.f, "100%" });
 
+    stereoModeBoxAttachment = attachStereoModeBox(stereoModeBox, audioProcessor.apvts, "SlewLimiter Stereo Mode " + std::to_string(chainPosition));
+
     bypassButton.setLookAndFeel(&lnf);
 
     auto safePtr = juce::Component::SafePointer<SlewLimiterModuleGUI>(this);
@@ -315,6 +395,7 @@ std::vector<juce::Component*> SlewLimiterModuleGUI::getAllComps()
         &slewLimiterRiseSlider,
         &slewLimiterFallSlider,
         &DCoffsetEnabledButton,
+        &stereoModeBox,
         // labels
         &driveLabel,
         &mixLabel,
@@ -337,7 +418,8 @@ std::vector<juce::Component*> SlewLimiterModuleGUI::getParamComps()
         &biasSlider,
         &slewLimiterRiseSlider,
         &slewLimiterFallSlider,
-        &DCoffsetEnabledButton
+        &DCoffsetEnabledButton,
+        &stereoModeBox
     };
 }
 
@@ -353,6 +435,7 @@ void SlewLimiterModuleGUI::updateParameters(const juce::Array<juce::var>& values
     slewLimiterRiseSlider.setValue(*(value++), juce::NotificationType::sendNotificationSync);
     slewLimiterFallSlider.setValue(*(value++), juce::NotificationType::sendNotificationSync);
     DCoffsetEnabledButton.setToggleState(*(value++), juce::NotificationType::sendNotificationSync);
+    stereoModeBox.setSelectedItemIndex(*(value++), juce::NotificationType::sendNotificationSync);
 }
 
 void SlewLimiterModuleGUI::resetParameters(unsigned int chainPosition)
@@ -364,6 +447,7 @@ void SlewLimiterModuleGUI::resetParameters(unsigned int chainPosition)
     auto rise = audioProcessor.apvts.getParameter("SlewLimiter Rise " + std::to_string(chainPosition));
     auto fall = audioProcessor.apvts.getParameter("SlewLimiter Fall " + std::to_string(chainPosition));
     auto dcOffset = audioProcessor.apvts.getParameter("SlewLimiter DCoffset Enabled " + std::to_string(chainPosition));
+    auto stereoMode = audioProcessor.apvts.getParameter("SlewLimiter Stereo Mode " + std::to_string(chainPosition));
     auto bypassed = audioProcessor.apvts.getParameter("SlewLimiter Bypassed " + std::to_string(chainPosition));
 
     drive->setValueNotifyingHost(drive->getDefaultValue());
@@ -373,6 +457,7 @@ void SlewLimiterModuleGUI::resetParameters(unsigned int chainPosition)
     rise->setValueNotifyingHost(rise->getDefaultValue());
     fall->setValueNotifyingHost(fall->getDefaultValue());
     dcOffset->setValueNotifyingHost(dcOffset->getDefaultValue());
+    stereoMode->setValueNotifyingHost(stereoMode->getDefaultValue());
     bypassed->setValueNotifyingHost(bypassed->getDefaultValue());
 }
 
@@ -388,6 +473,7 @@ juce::Array<juce::var> SlewLimiterModuleGUI::getParamValues()
     values.add(juce::var(slewLimiterRiseSlider.getValue()));
     values.add(juce::var(slewLimiterFallSlider.getValue()));
     values.add(juce::var(DCoffsetEnabledButton.getToggleState()));
+    values.add(juce::var(stereoModeBox.getSelectedItemIndex()));
 
     return values;
 }
@@ -448,6 +534,10 @@ void SlewLimiterModuleGUI::resized()
     title.setBounds(titleAndBypassArea);
     title.setJustificationType(juce::Justification::centredBottom);
 
+    // stereo mode on the right of the title
+    auto stereoModeArea = titleAndBypassArea;
+    stereoModeBox.setBounds(stereoModeArea.removeFromRight(100).reduced(4, 3));
+
     renderArea.setCentre(driveArea.getCentre());
     renderArea.setY(driveArea.getTopLeft().getY());
     driveSlider.setBounds(renderArea);
@@ -54,9 +54,19 @@ class BiztortionAudioProcessor;
 struct SlewLimiterSettings {
     float symmetry{ 0 }, bias{ 0 }, drive{ 0 }, mix{ 0 };
     float rise{ 0 }, fall{ 0 };
+    // StereoMode
+    int stereoMode{ 0 };
     bool bypassed{ false }, DCoffsetRemove{ false };
 };
 
+// APVTS parameters of one SlewLimiter chain slot
+struct SlewLimiterParameterHandles {
+    std::atomic<float>* symmetry{ nullptr }, * bias{ nullptr }, * drive{ nullptr }, * mix{ nullptr };
+    std::atomic<float>* rise{ nullptr }, * fall{ nullptr };
+    std::atomic<float>* stereoMode{ nullptr };
+    std::atomic<float>* bypassed{ nullptr }, * DCoffsetRemove{ nullptr };
+};
+
 using Filter = juce::dsp::IIR::Filter<float>;
 
 
@@ -66,27 +76,50 @@ public:
 
     void setModuleType() override;
     void updateDSPState(double sampleRate) override;
-    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels) override;
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, double sampleRate) override;
+    int getTailSamples() override;
+    bool isIdle() noexcept override;
 
     static void addParameters(juce::AudioProcessorValueTreeState::ParameterLayout&);
     static SlewLimiterSettings getSettings(juce::AudioProcessorValueTreeState& apvts, unsigned int chainPosition);
+    static SlewLimiterSettings getSettings(const SlewLimiterParameterHandles& handles);
+    static SlewLimiterParameterHandles getParameterHandles(juce::AudioProcessorValueTreeState& apvts, unsigned int chainPosition);
+
+protected:
+    void cacheParameterHandles() override;
+    void resetChannelState() noexcept override;
+    // the slew tail depends on where the outputs were left, not on a fixed length
+    bool isTailSilent(int silentSamples) override;
 
 private:
+    // slope (in units per sample) for a normalized rise/fall value
+    float getSlope(float normalizedValue) const noexcept;
 
+    SlewLimiterParameterHandles parameterHandles;
     bool bypassed = false;
     juce::LinearSmoothedValue<float> symmetry, bias;
     juce::LinearSmoothedValue<float> driveGain, dryGain, wetGain;
     juce::LinearSmoothedValue<float> rise, fall;
-    juce::AudioBuffer<float> wetBuffer, tempBuffer;
-    Filter leftDCoffsetRemoveHPF, rightDCoffsetRemoveHPF;
+    // one per channel
+    std::vector<Filter> DCoffsetRemoveHPFs;
     bool DCoffsetRemoveEnabled = false;
 
     // minimum slope in volts per second
     const float slewMin = 0.1f;
     // maximum slope in volts per second
     const float slewMax = 10000.f;
-    float lastOutput = 0.f;
+    // slewMax / sampleRate and log(slewMin / slewMax), set in prepareToPlay
+    float slopeScale = 0.f, slopeRange = 0.f;
+    // slopes cached for the current (not smoothing) rise/fall targets
+    float riseSlope = 0.f, fallSlope = 0.f;
+    float riseSlopeTarget = -1.f, fallSlopeTarget = -1.f;
+    // last output of each channel
+    std::vector<float> lastOutput;
+    // samples since every lastOutput fell below silenceThreshold
+    int settledSamples = 0;
+    // decay of the DC offset remove HPF and cap of the reported tail, set in prepareToPlay
+    int DCoffsetRemoveTailSamples = 0, maxTailSamples = 0;
 
 };
 
@@ -115,6 +148,7 @@ private:
     using APVTS = juce::AudioProcessorValueTreeState;
     using Attachment = APVTS::SliderAttachment;
     using ButtonAttachment = APVTS::ButtonAttachment;
+    using ComboBoxAttachment = APVTS::ComboBoxAttachment;
 
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
@@ -133,6 +167,9 @@ private:
 
     juce::Label DCoffsetEnabledButtonLabel;
 
+    juce::ComboBox stereoModeBox;
+    std::unique_ptr<ComboBoxAttachment> stereoModeBoxAttachment;
+
     juce::Label driveLabel,
         mixLabel,
         symmetryLabel,
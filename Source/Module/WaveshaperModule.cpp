@@ -56,13 +56,129 @@ void WaveshaperModuleDSP::setModuleType()
     moduleType = ModuleType::Waveshaper;
 }
 
-void WaveshaperModuleDSP::prepareToPlay(double sampleRate, int samplesPerBlock)
+void WaveshaperModuleDSP::prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels)
 {
-    wetBuffer.setSize(2, samplesPerBlock, false, true, true); // clears
-    tempBuffer.setSize(2, samplesPerBlock, false, true, true); // clears
+    initOversamplers(numChannels, samplesPerBlock);
+
+    int maxLatency = 0;
+    for (auto& os : oversamplers) {
+        maxLatency = juce::jmax(maxLatency, juce::roundToInt(os->getLatencyInSamples()));
+    }
+    juce::dsp::ProcessSpec spec;
+    spec.maximumBlockSize = samplesPerBlock;
+    spec.numChannels = numChannels;
+    spec.sampleRate = sampleRate;
+    dryDelay.setMaximumDelayInSamples(maxLatency);
+    dryDelay.prepare(spec);
+    prepareSkippedLane(sampleRate, samplesPerBlock, maxLatency);
+
+    // the oversampling mode is selected again by updateDSPState
+    oversampler = nullptr;
+    oversamplerIndex = -1;
+    latencySamples = 0;
+    dryDelay.setDelay(0.f);
+
     updateDSPState(sampleRate);
-    /*oversampler.initProcessing(samplesPerBlock);
-    oversampler.reset();*/
+    prepareBypassFade(sampleRate, bypassed);
+    resetShaperSmoothing(sampleRate);
+}
+
+void WaveshaperModuleDSP::resetShaperSmoothing(double sampleRate)
+{
+    const auto factor = oversampler != nullptr ? (double)oversampler->getOversamplingFactor() : 1.0;
+    symmetry.reset(sampleRate * factor, 0.05);
+    bias.reset(sampleRate * factor, 0.05);
+}
+
+void WaveshaperModuleDSP::initOversamplers(int numChannels, int samplesPerBlock)
+{
+    const auto rebuild = numChannels != oversamplersNumChannels;
+    if (rebuild) {
+        for (int order = 1; order <= maxOversamplingOrder; ++order) {
+            oversamplers[order - 1] = std::make_unique<juce::dsp::Oversampling<float>>(
+                numChannels, order, juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true, true);
+            oversamplers[maxOversamplingOrder + order - 1] = std::make_unique<juce::dsp::Oversampling<float>>(
+                numChannels, order, juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple, true, true);
+        }
+        oversamplersNumChannels = numChannels;
+    }
+    for (size_t i = 0; i < oversamplers.size(); ++i) {
+        oversamplers[i]->initProcessing(samplesPerBlock);
+        // the tails don't depend on the block size or on the sample rate
+        if (rebuild) {
+            oversamplerTails[i] = measureOversamplerTail(*oversamplers[i], samplesPerBlock);
+        }
+        oversamplers[i]->reset();
+    }
+    oversamplersBlockSize = samplesPerBlock;
+}
+
+int WaveshaperModuleDSP::measureOversamplerTail(juce::dsp::Oversampling<float>& os, int samplesPerBlock)
+{
+    // an impulse through the filters, block by block until a whole block after the latency stays silent
+    const auto latency = juce::roundToInt(os.getLatencyInSamples());
+    const auto maxSamples = juce::jmax(samplesPerBlock, 1 << 15);
+    juce::AudioBuffer<float> probe(1, samplesPerBlock);
+    os.reset();
+    int tail = 0;
+    for (int start = 0; start < maxSamples; start += samplesPerBlock) {
+        probe.clear();
+        if (start == 0) {
+            probe.setSample(0, 0, 1.f);
+        }
+        juce::dsp::AudioBlock<float> block(probe);
+        os.processSamplesUp(block);
+        os.processSamplesDown(block);
+
+        auto silentBlock = true;
+        for (int i = 0; i < samplesPerBlock; ++i) {
+            if (std::abs(probe.getSample(0, i)) > silenceThreshold) {
+                tail = start + i + 1;
+                silentBlock = false;
+            }
+        }
+        if (silentBlock && start > latency) {
+            break;
+        }
+    }
+    return tail;
+}
+
+int WaveshaperModuleDSP::getTailSamples()
+{
+    // bypassed, only the dry delay is left
+    if (isFullyBypassed() || oversampler == nullptr) {
+        return latencySamples;
+    }
+    return juce::jmax(latencySamples, oversamplerTails[(size_t)oversamplerIndex]);
+}
+
+int WaveshaperModuleDSP::getLatencySamples()
+{
+    return latencySamples;
+}
+
+bool WaveshaperModuleDSP::isIdle() noexcept
+{
+    return isDryOnly(parameterHandles.bypassed, parameterHandles.mix, wetGain);
+}
+
+void WaveshaperModuleDSP::resetChannelState() noexcept
+{
+    DSPModule::resetChannelState();
+    if (oversampler != nullptr)
+        oversampler->reset();
+    dryDelay.reset();
+}
+
+void WaveshaperModuleDSP::processIdle(juce::AudioBuffer<float>& buffer) noexcept
+{
+    // the same dry delay of the bypassed processBlock
+    if (latencySamples > 0) {
+        juce::dsp::AudioBlock<float> dryBlock(buffer);
+        dryBlock = dryBlock.getSubsetChannelBlock(0, (size_t)juce::jmin(buffer.getNumChannels(), oversamplersNumChannels));
+        delayBlock(dryDelay, dryBlock);
+    }
 }
 
 void WaveshaperModuleDSP::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, double sampleRate)
@@ -70,77 +186,125 @@ void WaveshaperModuleDSP::processBlock(juce::AudioBuffer<float>& buffer, juce::M
 
     updateDSPState(sampleRate);
 
-    if (!bypassed) {
+    // the processor never passes more samples than the prepared block size
+    int numSamples = buffer.getNumSamples();
+    jassert(numSamples <= oversamplersBlockSize);
+    const auto numChannels = juce::jmin(buffer.getNumChannels(), oversamplersNumChannels);
 
-        // SAFETY CHECK :::: since some hosts will change buffer sizes without calling prepToPlay (ex: Bitwig)
-        int numSamples = buffer.getNumSamples();
-        if (wetBuffer.getNumSamples() != numSamples)
-        {
-            wetBuffer.setSize(2, numSamples, false, true, true); // clears
-            tempBuffer.setSize(2, numSamples, false, true, true); // clears
-        }
-        
-        // Wet Buffer feeding
-        for (auto channel = 0; channel < 2; channel++)
-            wetBuffer.copyFrom(channel, 0, buffer, channel, 0, numSamples);
-
-        // Oversampling wetBuffer for processing
-        /*juce::dsp::AudioBlock<float> block(wetBuffer);
-        auto leftBlock = block.getSingleChannelBlock(0);
-        auto rightBlock = block.getSingleChannelBlock(1);
-        juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
-        juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
-        auto oversampledLeftBlock = oversampler.processSamplesUp(leftContext.getInputBlock());
-        auto oversampledRightBlock = oversampler.processSamplesUp(rightContext.getInputBlock());*/
-
-        // Drive
-        driveGain.applyGain(wetBuffer, numSamples);
-
-        // Temp Buffer feeding for applying asymmetry
-        for (auto channel = 0; channel < 2; channel++)
-            tempBuffer.copyFrom(channel, 0, wetBuffer, channel, 0, numSamples);
-
-        // Waveshaper
-        for (auto channel = 0; channel < 2; channel++)
-        {
-            auto* channelData = wetBuffer.getWritePointer(channel);
+    juce::dsp::AudioBlock<float> dryBlock(buffer);
+    dryBlock = dryBlock.getSubsetChannelBlock(0, (size_t)numChannels);
 
-            for (auto i = 0; i < numSamples; i++)
-                channelData[i] = tanhAmp.getNextValue() * std::tanh(channelData[i] * tanhSlope.getNextValue())
-                + sineAmp.getNextValue() * std::sin(channelData[i] * sineFreq.getNextValue());
+    if (isFullyBypassed()) {
+        // the dry signal is delayed anyway, so that the latency reported to the host doesn't depend on the bypass
+        if (latencySamples > 0) {
+            delayBlock(dryDelay, dryBlock);
         }
+        return;
+    }
 
-        // Sampling back down the wetBuffer after processing
-        /*oversampler.processSamplesDown(leftContext.getOutputBlock());
-        oversampler.processSamplesDown(rightContext.getOutputBlock());
+    // parameters computed once per sample for all the channels (ramps 3 - 8 are the shaper ones)
+    auto* drive = getRamp(driveGain, 0, numSamples);
+    auto* dry = getRamp(dryGain, 1, numSamples);
+    auto* wet = getRamp(wetGain, 2, numSamples);
+    foldBypassFade(dry, wet, numSamples);
+
+    if (oversampler == nullptr) {
+        // fused kernel: drive -> waveshaper -> asymmetry -> mix -> hard clipper in a single pass per channel
+        auto* tAmp = getRamp(tanhAmp, 3, numSamples);
+        auto* tSlope = getRamp(tanhSlope, 4, numSamples);
+        auto* sAmp = getRamp(sineAmp, 5, numSamples);
+        auto* sFreq = getRamp(sineFreq, 6, numSamples);
+        auto* symmetryAmount = getRamp(symmetry, 7, numSamples);
+        auto* symmetryBias = getRamp(bias, 8, numSamples);
+        for (auto channel = 0; channel < numChannels; ++channel) {
+            auto* data = buffer.getWritePointer(channel);
+            for (auto i = 0; i < numSamples; i++) {
+                auto shaped = shapeSample(data[i] * drive[i], tAmp[i], tSlope[i], sAmp[i], sFreq[i], symmetryAmount[i], symmetryBias[i]);
+                data[i] = juce::jlimit(-1.f, 1.f, data[i] * dry[i] + shaped * wet[i]);
+            }
+        }
+        return;
+    }
 
-        auto* channelData = wetBuffer.getWritePointer(0);
-        for (auto i = 0; i < numSamples; i++)
-            channelData[i] = leftContext.getOutputBlock().getSample(0, i);
-        channelData = wetBuffer.getWritePointer(1);
+    // Wet Buffer (borrowed from the scratch arena) feeding and drive (linear, so it is applied before oversampling)
+    auto wetBuffer = scratchArena->getBuffer(ScratchArena::Wet, numSamples);
+    for (auto channel = 0; channel < numChannels; ++channel) {
+        auto* data = buffer.getReadPointer(channel);
+        auto* wetData = wetBuffer.getWritePointer(channel);
         for (auto i = 0; i < numSamples; i++)
-            channelData[i] = rightContext.getOutputBlock().getSample(0, i);*/
-
-        applyAsymmetry(tempBuffer, wetBuffer, symmetry.getNextValue(), bias.getNextValue(), numSamples);
+            wetData[i] = data[i] * drive[i];
+    }
 
-        // Mixing buffers
-        dryGain.applyGain(buffer, numSamples);
-        wetGain.applyGain(tempBuffer, numSamples);
+    // Oversampling wetBuffer for processing
+    juce::dsp::AudioBlock<float> wetBlock(wetBuffer);
+    wetBlock = wetBlock.getSubsetChannelBlock(0, (size_t)numChannels);
+    auto oversampledBlock = oversampler->processSamplesUp(wetBlock);
+    // in place in the oversampler memory
+    std::array<float*, maxNumChannels> oversampledChannels{};
+    for (auto channel = 0; channel < numChannels; ++channel)
+        oversampledChannels[(size_t)channel] = oversampledBlock.getChannelPointer((size_t)channel);
+    applyWaveshaper(oversampledChannels.data(), numChannels, (int)oversampledBlock.getNumSamples());
+
+    // Sampling back down the wetBuffer after processing
+    oversampler->processSamplesDown(wetBlock);
+
+    // Dry signal aligned with the oversampled wet signal
+    if (latencySamples > 0) {
+        delayBlock(dryDelay, dryBlock);
+    }
 
-        for (auto channel = 0; channel < 2; channel++)
-            buffer.addFrom(channel, 0, tempBuffer, channel, 0, numSamples);
+    // Mixing buffers and hard clipper for limiting, in a single pass per channel
+    for (auto channel = 0; channel < numChannels; ++channel) {
+        auto* data = buffer.getWritePointer(channel);
+        auto* wetData = wetBuffer.getReadPointer(channel);
+        for (auto i = 0; i < numSamples; i++)
+            data[i] = juce::jlimit(-1.f, 1.f, data[i] * dry[i] + wetData[i] * wet[i]);
+    }
+}
 
-        // Hard clipper for limiting
-        for (auto channel = 0; channel < 2; channel++)
-        {
-            auto* channelData = buffer.getWritePointer(channel);
+void WaveshaperModuleDSP::applyWaveshaper(float* const* channels, int numChannels, int numSamples)
+{
+    const auto smoothing = tanhAmp.isSmoothing() || tanhSlope.isSmoothing() || sineAmp.isSmoothing()
+        || sineFreq.isSmoothing() || symmetry.isSmoothing() || bias.isSmoothing();
+
+    auto* pool = getWorkerPool();
+    if (!smoothing && pool != nullptr && numSamples >= minSamplesPerLane) {
+        // constant parameters: the channels are independent and are shaped concurrently
+        ShaperLanes lanes{ {}, numSamples,
+            { tanhAmp.getTargetValue(), tanhSlope.getTargetValue(), sineAmp.getTargetValue(),
+              sineFreq.getTargetValue(), symmetry.getTargetValue(), bias.getTargetValue() } };
+        std::copy(channels, channels + numChannels, lanes.channels.begin());
+        pool->run(numChannels, &WaveshaperModuleDSP::shapeLane, &lanes);
+        return;
+    }
 
-            for (auto i = 0; i < numSamples; i++)
-                channelData[i] = juce::jlimit(-1.f, 1.f, channelData[i]);
+    // the oversampled block is longer than the ramps: parameters computed once per sample, one chunk at a time
+    const auto rampSize = scratchArena->getMaxBlockSize();
+    for (auto start = 0; start < numSamples; start += rampSize) {
+        const auto chunkSize = juce::jmin(rampSize, numSamples - start);
+        auto* tAmp = getRamp(tanhAmp, 3, chunkSize);
+        auto* tSlope = getRamp(tanhSlope, 4, chunkSize);
+        auto* sAmp = getRamp(sineAmp, 5, chunkSize);
+        auto* sFreq = getRamp(sineFreq, 6, chunkSize);
+        auto* symmetryAmount = getRamp(symmetry, 7, chunkSize);
+        auto* symmetryBias = getRamp(bias, 8, chunkSize);
+        for (auto channel = 0; channel < numChannels; ++channel) {
+            auto* data = channels[channel] + start;
+            for (auto i = 0; i < chunkSize; i++)
+                data[i] = shapeSample(data[i], tAmp[i], tSlope[i], sAmp[i], sFreq[i], symmetryAmount[i], symmetryBias[i]);
         }
     }
 }
 
+void WaveshaperModuleDSP::shapeLane(void* context, int lane)
+{
+    const auto& lanes = *static_cast<const ShaperLanes*>(context);
+    const auto& p = lanes.parameters;
+    auto* data = lanes.channels[lane];
+    for (auto i = 0; i < lanes.numSamples; i++)
+        data[i] = shapeSample(data[i], p.tanhAmp, p.tanhSlope, p.sineAmp, p.sineFreq, p.symmetryAmount, p.symmetryBias);
+}
+
 void WaveshaperModuleDSP::addParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout)
 {
     using namespace juce;
@@ -154,32 +318,70 @@ void WaveshaperModuleDSP::addParameters(juce::AudioProcessorValueTreeState::Para
         layout.add(std::make_unique<AudioParameterFloat>("Waveshaper Tanh Slope " + std::to_string(i), "Waveshaper Tanh Slope " + std::to_string(i), NormalisableRange<float>(1.f, 15.f, 0.01f), 1.f, "Waveshaper " + std::to_string(i)));
         layout.add(std::make_unique<AudioParameterFloat>("Waveshaper Sine Amp " + std::to_string(i), "Waveshaper Sin Amp " + std::to_string(i), NormalisableRange<float>(0.f, 100.f, 0.01f), 0.f, "Waveshaper " + std::to_string(i)));
         layout.add(std::make_unique<AudioParameterFloat>("Waveshaper Sine Freq " + std::to_string(i), "Waveshaper Sin Freq " + std::to_string(i), NormalisableRange<float>(0.5f, 100.f, 0.01f), 0.5f, "Waveshaper " + std::to_string(i)));
+        layout.add(std::make_unique<AudioParameterChoice>("Waveshaper Oversampling " + std::to_string(i), "Waveshaper Oversampling " + std::to_string(i), StringArray{ "1x", "2x", "4x", "8x", "16x" }, 0, "Waveshaper " + std::to_string(i)));
+        layout.add(std::make_unique<AudioParameterChoice>("Waveshaper Oversampling Filter " + std::to_string(i), "Waveshaper Oversampling Filter " + std::to_string(i), StringArray{ "IIR", "FIR" }, 0, "Waveshaper " + std::to_string(i)));
+        addStereoModeParameter(layout, "Waveshaper", i);
         layout.add(std::make_unique<AudioParameterBool>("Waveshaper Bypassed " + std::to_string(i), "Waveshaper Bypassed " + std::to_string(i), false, "Waveshaper " + std::to_string(i)));
     }
 }
 
 WaveshaperSettings WaveshaperModuleDSP::getSettings(juce::AudioProcessorValueTreeState& apvts, unsigned int chainPosition)
+{
+    return getSettings(getParameterHandles(apvts, chainPosition));
+}
+
+WaveshaperSettings WaveshaperModuleDSP::getSettings(const WaveshaperParameterHandles& handles)
 {
     WaveshaperSettings settings;
 
-    settings.drive = apvts.getRawParameterValue("Waveshaper Drive " + std::to_string(chainPosition))->load();
-    settings.mix = apvts.getRawParameterValue("Waveshaper Mix " + std::to_string(chainPosition))->load();
-    settings.symmetry = apvts.getRawParameterValue("Waveshaper Symmetry " + std::to_string(chainPosition))->load();
-    settings.bias = apvts.getRawParameterValue("Waveshaper Bias " + std::to_string(chainPosition))->load();
-    settings.tanhAmp = apvts.getRawParameterValue("Waveshaper Tanh Amp " + std::to_string(chainPosition))->load();
-    settings.tanhSlope = apvts.getRawParameterValue("Waveshaper Tanh Slope " + std::to_string(chainPosition))->load();
-    settings.sinAmp = apvts.getRawParameterValue("Waveshaper Sine Amp " + std::to_string(chainPosition))->load();
-    settings.sinFreq = apvts.getRawParameterValue("Waveshaper Sine Freq " + std::to_string(chainPosition))->load();
-    settings.bypassed = apvts.getRawParameterValue("Waveshaper Bypassed " + std::to_string(chainPosition))->load() > 0.5f;
+    settings.drive = handles.drive->load();
+    settings.mix = handles.mix->load();
+    settings.symmetry = handles.symmetry->load();
+    settings.bias = handles.bias->load();
+    settings.tanhAmp = handles.tanhAmp->load();
+    settings.tanhSlope = handles.tanhSlope->load();
+    settings.sinAmp = handles.sinAmp->load();
+    settings.sinFreq = handles.sinFreq->load();
+    settings.oversampling = static_cast<int>(handles.oversampling->load());
+    settings.oversamplingFilter = static_cast<int>(handles.oversamplingFilter->load());
+    settings.stereoMode = static_cast<int>(handles.stereoMode->load());
+    settings.bypassed = handles.bypassed->load() > 0.5f;
 
     return settings;
 }
 
+WaveshaperParameterHandles WaveshaperModuleDSP::getParameterHandles(juce::AudioProcessorValueTreeState& apvts, unsigned int chainPosition)
+{
+    WaveshaperParameterHandles handles;
+
+    handles.drive = apvts.getRawParameterValue("Waveshaper Drive " + std::to_string(chainPosition));
+    handles.mix = apvts.getRawParameterValue("Waveshaper Mix " + std::to_string(chainPosition));
+    handles.symmetry = apvts.getRawParameterValue("Waveshaper Symmetry " + std::to_string(chainPosition));
+    handles.bias = apvts.getRawParameterValue("Waveshaper Bias " + std::to_string(chainPosition));
+    handles.tanhAmp = apvts.getRawParameterValue("Waveshaper Tanh Amp " + std::to_string(chainPosition));
+    handles.tanhSlope = apvts.getRawParameterValue("Waveshaper Tanh Slope " + std::to_string(chainPosition));
+    handles.sinAmp = apvts.getRawParameterValue("Waveshaper Sine Amp " + std::to_string(chainPosition));
+    handles.sinFreq = apvts.getRawParameterValue("Waveshaper Sine Freq " + std::to_string(chainPosition));
+    handles.oversampling = apvts.getRawParameterValue("Waveshaper Oversampling " + std::to_string(chainPosition));
+    handles.oversamplingFilter = apvts.getRawParameterValue("Waveshaper Oversampling Filter " + std::to_string(chainPosition));
+    handles.stereoMode = apvts.getRawParameterValue("Waveshaper Stereo Mode " + std::to_string(chainPosition));
+    handles.bypassed = apvts.getRawParameterValue("Waveshaper Bypassed " + std::to_string(chainPosition));
+
+    return handles;
+}
+
+void WaveshaperModuleDSP::cacheParameterHandles()
+{
+    parameterHandles = getParameterHandles(apvts, getChainPosition());
+}
+
 void WaveshaperModuleDSP::updateDSPState(double)
 {
-    auto settings = getSettings(apvts, getChainPosition());
+    auto settings = getSettings(parameterHandles);
 
     bypassed = settings.bypassed;
+    setBypassFadeTarget(bypassed);
+    stereoMode = static_cast<StereoMode>(settings.stereoMode);
 
     auto mix = settings.mix * 0.01f;
     dryGain.setTargetValue(1.f - mix);
@@ -192,6 +394,25 @@ void WaveshaperModuleDSP::updateDSPState(double)
     tanhSlope.setTargetValue(settings.tanhSlope);
     sineAmp.setTargetValue(settings.sinAmp * 0.01f);
     sineFreq.setTargetValue(settings.sinFreq);
+
+    // oversampling mode
+    int index = settings.oversampling == 0 ? -1
+        : (settings.oversampling - 1) + settings.oversamplingFilter * maxOversamplingOrder;
+    if (index != oversamplerIndex) {
+        oversamplerIndex = index;
+        oversampler = index < 0 ? nullptr : oversamplers[index].get();
+        if (oversampler != nullptr) {
+            oversampler->reset();
+        }
+        resetShaperSmoothing(sampleRate);
+        const auto latency = oversampler != nullptr ? juce::roundToInt(oversampler->getLatencyInSamples()) : 0;
+        if (latency != latencySamples) {
+            // the samples stored for the old latency would come out misaligned with the new oversampler
+            latencySamples = latency;
+            dryDelay.reset();
+            dryDelay.setDelay((float)latencySamples);
+        }
+    }
 }
 
 //==============================================================================
@@ -260,6 +481,21 @@ WaveshaperModuleGUI::WaveshaperModuleGUI(BiztortionAudioProcessor& p, unsigned i
     sineFreqSlider.labels.add({ 0.f, "0.5" });
     sineFreqSlider.labels.add({ 1.f, "100" });
 
+    // oversampling
+    auto oversamplingParameter = dynamic_cast<juce::AudioParameterChoice*>(audioProcessor.apvts.getParameter("Waveshaper Oversampling " + std::to_string(chainPosition)));
+    auto oversamplingFilterParameter = dynamic_cast<juce::AudioParameterChoice*>(audioProcessor.apvts.getParameter("Waveshaper Oversampling Filter " + std::to_string(chainPosition)));
+    oversamplingBox.addItemList(oversamplingParameter->choices, 1);
+    oversamplingFilterBox.addItemList(oversamplingFilterParameter->choices, 1);
+    oversamplingBoxAttachment = std::make_unique<ComboBoxAttachment>(audioProcessor.apvts, "Waveshaper Oversampling " + std::to_string(chainPosition), oversamplingBox);
+    oversamplingFilterBoxAttachment = std::make_unique<ComboBoxAttachment>(audioProcessor.apvts, "Waveshaper Oversampling Filter " + std::to_string(chainPosition), oversamplingFilterBox);
+    for (auto* box : { &oversamplingBox, &oversamplingFilterBox }) {
+        box->setColour(juce::ComboBox::backgroundColourId, juce::Colours::darkgrey.withAlpha(0.75f));
+        box->setColour(juce::ComboBox::textColourId, juce::Colours::white);
+        box->setColour(juce::ComboBox::outlineColourId, juce::Colours::white);
+        box->setJustificationType(juce::Justification::centred);
+    }
+    stereoModeBoxAttachment = attachStereoModeBox(stereoModeBox, audioProcessor.apvts, "Waveshaper Stereo Mode " + std::to_string(chainPosition));
+
     bypassButton.setLookAndFeel(&lnf);
 
     auto safePtr = juce::Component::SafePointer<WaveshaperModuleGUI>(this);
@@ -282,6 +518,8 @@ WaveshaperModuleGUI::WaveshaperModuleGUI(BiztortionAudioProcessor& p, unsigned i
     tanhSlopeSlider.setTooltip("Set the hyperbolic tangent function slope");
     sineAmpSlider.setTooltip("Set the sine function amplitude");
     sineFreqSlider.setTooltip("Set the sine function frequency");
+    oversamplingBox.setTooltip("Select the oversampling factor of the waveshaper (adds latency)");
+    oversamplingFilterBox.setTooltip("Select the oversampling filter: polyphase IIR (low latency) or FIR (linear phase)");
 
     for (auto* comp : getAllComps())
     {
@@ -318,6 +556,10 @@ std::vector<juce::Component*> WaveshaperModuleGUI::getAllComps()
         &tanhSlopeLabel,
         &sineAmpLabel,
         &sineFreqLabel,
+        // oversampling
+        &oversamplingBox,
+        &oversamplingFilterBox,
+        &stereoModeBox,
         // bypass
         &bypassButton
     };
@@ -333,7 +575,10 @@ std::vector<juce::Component*> WaveshaperModuleGUI::getParamComps()
         &tanhAmpSlider,
         &tanhSlopeSlider,
         &sineAmpSlider,
-        &sineFreqSlider
+        &sineFreqSlider,
+        &oversamplingBox,
+        &oversamplingFilterBox,
+        &stereoModeBox
     };
 }
 
@@ -350,6 +595,9 @@ void WaveshaperModuleGUI::updateParameters(const juce::Array<juce::var>& values)
     tanhSlopeSlider.setValue(*(value++), juce::NotificationType::sendNotificationSync);
     sineAmpSlider.setValue(*(value++), juce::NotificationType::sendNotificationSync);
     sineFreqSlider.setValue(*(value++), juce::NotificationType::sendNotificationSync);
+    oversamplingBox.setSelectedItemIndex(*(value++), juce::NotificationType::sendNotificationSync);
+    oversamplingFilterBox.setSelectedItemIndex(*(value++), juce::NotificationType::sendNotificationSync);
+    stereoModeBox.setSelectedItemIndex(*(value++), juce::NotificationType::sendNotificationSync);
 }
 
 void WaveshaperModuleGUI::resetParameters(unsigned int chainPosition)
@@ -362,6 +610,9 @@ void WaveshaperModuleGUI::resetParameters(unsigned int chainPosition)
     auto tanhSlope = audioProcessor.apvts.getParameter("Waveshaper Tanh Slope " + std::to_string(chainPosition));
     auto sineAmp = audioProcessor.apvts.getParameter("Waveshaper Sine Amp " + std::to_string(chainPosition));
     auto sineFreq = audioProcessor.apvts.getParameter("Waveshaper Sine Freq " + std::to_string(chainPosition));
+    auto oversampling = audioProcessor.apvts.getParameter("Waveshaper Oversampling " + std::to_string(chainPosition));
+    auto oversamplingFilter = audioProcessor.apvts.getParameter("Waveshaper Oversampling Filter " + std::to_string(chainPosition));
+    auto stereoMode = audioProcessor.apvts.getParameter("Waveshaper Stereo Mode " + std::to_string(chainPosition));
     auto bypassed = audioProcessor.apvts.getParameter("Waveshaper Bypassed " + std::to_string(chainPosition));
 
     drive->setValueNotifyingHost(drive->getDefaultValue());
@@ -372,6 +623,9 @@ void WaveshaperModuleGUI::resetParameters(unsigned int chainPosition)
     tanhSlope->setValueNotifyingHost(tanhSlope->getDefaultValue());
     sineAmp->setValueNotifyingHost(sineAmp->getDefaultValue());
     sineFreq->setValueNotifyingHost(sineFreq->getDefaultValue());
+    oversampling->setValueNotifyingHost(oversampling->getDefaultValue());
+    oversamplingFilter->setValueNotifyingHost(oversamplingFilter->getDefaultValue());
+    stereoMode->setValueNotifyingHost(stereoMode->getDefaultValue());
     bypassed->setValueNotifyingHost(bypassed->getDefaultValue());
 }
 
@@ -388,6 +642,9 @@ juce::Array<juce::var> WaveshaperModuleGUI::getParamValues()
     values.add(juce::var(tanhSlopeSlider.getValue()));
     values.add(juce::var(sineAmpSlider.getValue()));
     values.add(juce::var(sineFreqSlider.getValue()));
+    values.add(juce::var(oversamplingBox.getSelectedItemIndex()));
+    values.add(juce::var(oversamplingFilterBox.getSelectedItemIndex()));
+    values.add(juce::var(stereoModeBox.getSelectedItemIndex()));
 
     return values;
 }
@@ -415,6 +672,8 @@ void WaveshaperModuleGUI::resized()
     titleAndBypassArea.translate(0, 4);
 
     auto waveshaperGraphArea = waveshaperArea.removeFromLeft(waveshaperArea.getWidth() * (4.f / 10.f));
+    auto oversamplingArea = waveshaperGraphArea.removeFromBottom(30);
+    oversamplingArea.reduce(10, 3);
     waveshaperGraphArea.reduce(10, 10);
 
     waveshaperArea.translate(0, 8);
@@ -455,8 +714,15 @@ void WaveshaperModuleGUI::resized()
     title.setBounds(titleAndBypassArea);
     title.setJustificationType(juce::Justification::centredBottom);
 
+    // stereo mode on the right of the title
+    auto stereoModeArea = titleAndBypassArea;
+    stereoModeBox.setBounds(stereoModeArea.removeFromRight(100).reduced(4, 3));
+
     transferFunctionGraph.setBounds(waveshaperGraphArea);
 
+    oversamplingBox.setBounds(oversamplingArea.removeFromLeft(oversamplingArea.getWidth() / 2).reduced(2, 0));
+    oversamplingFilterBox.setBounds(oversamplingArea.reduced(2, 0));
+
     renderArea.setCentre(driveArea.getCentre());
     renderArea.setY(driveArea.getTopLeft().getY());
     driveSlider.setBounds(renderArea);
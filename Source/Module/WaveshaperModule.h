@@ -55,53 +55,21 @@ class BiztortionAudioProcessor;
 struct WaveshaperSettings {
     float mix{ 0 }, drive{ 0 }, symmetry{ 0 }, bias{ 0 };
     float tanhAmp{ 0 }, tanhSlope{ 0 }, sinAmp{ 0 }, sinFreq{ 0 };
+    // oversampling: 0 = 1x ... 4 = 16x, filter: 0 = polyphase IIR, 1 = FIR
+    int oversampling{ 0 }, oversamplingFilter{ 0 };
+    // StereoMode
+    int stereoMode{ 0 };
     bool bypassed{ false };
 };
 
-// TODO : implementing oversampling
-//class Waveshaper : public juce::dsp::ProcessorBase
-//{
-//public:
-//    Waveshaper()
-//    {
-//        
-//        waveshaper.functionToUse = [](float in)
-//        {
-//            float out = tanhAmp.getNextValue() * std::tanh(in * tanhSlope.getNextValue())
-//                + sineAmp.getNextValue() * std::sin(in * sineFreq.getNextValue());
-//
-//            return out;
-//        };
-//    }
-//
-//    void prepare(const juce::dsp::ProcessSpec& spec) override
-//    {
-//        oversampler.initProcessing(spec.maximumBlockSize);
-//    }
-//
-//    void process(const juce::dsp::ProcessContextReplacing<float>& context) override
-//    {
-//        // First sample up...
-//        auto oversampledBlock = oversampler.processSamplesUp(context.getInputBlock());
-//        // Then process with the waveshaper...
-//        waveshaper.process(juce::dsp::ProcessContextReplacing<float>(oversampledBlock));
-//        // Finally sample back down
-//        oversampler.processSamplesDown(context.getOutputBlock());
-//    }
-//
-//    void reset() override { oversampler.reset(); }
-//
-//    float getLatencyInSamples() { return oversampler.getLatencyInSamples(); }
-//
-//private:
-//    static const size_t numChannels = 1;
-//    static const size_t oversamplingOrder = 4;
-//    static const int    oversamplingFactor = 1 << oversamplingOrder;
-//    static const auto filterType = juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR;
-//
-//    juce::dsp::Oversampling<float> oversampler{ numChannels, oversamplingOrder, filterType };
-//    juce::dsp::WaveShaper<float> waveshaper;
-//};
+// APVTS parameters of one Waveshaper chain slot
+struct WaveshaperParameterHandles {
+    std::atomic<float>* mix{ nullptr }, * drive{ nullptr }, * symmetry{ nullptr }, * bias{ nullptr };
+    std::atomic<float>* tanhAmp{ nullptr }, * tanhSlope{ nullptr }, * sinAmp{ nullptr }, * sinFreq{ nullptr };
+    std::atomic<float>* oversampling{ nullptr }, * oversamplingFilter{ nullptr };
+    std::atomic<float>* stereoMode{ nullptr };
+    std::atomic<float>* bypassed{ nullptr };
+};
 
 class WaveshaperModuleDSP : public DSPModule {
 public:
@@ -110,26 +78,79 @@ public:
     void setModuleType() override;
 
     void updateDSPState(double sampleRate) override;
-    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels) override;
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, double sampleRate) override;
+    int getLatencySamples() override;
+    int getTailSamples() override;
+    bool isIdle() noexcept override;
+    void processIdle(juce::AudioBuffer<float>& buffer) noexcept override;
 
     static void addParameters(juce::AudioProcessorValueTreeState::ParameterLayout&);
     static WaveshaperSettings getSettings(juce::AudioProcessorValueTreeState& apvts, unsigned int chainPosition);
+    static WaveshaperSettings getSettings(const WaveshaperParameterHandles& handles);
+    static WaveshaperParameterHandles getParameterHandles(juce::AudioProcessorValueTreeState& apvts, unsigned int chainPosition);
+
+protected:
+    void cacheParameterHandles() override;
+    void resetChannelState() noexcept override;
 
 private:
 
+    // waveshaper function followed by the asymmetry, for one driven sample
+    static inline float shapeSample(float driven, float tanhAmp, float tanhSlope, float sineAmp, float sineFreq, float symmetryAmount, float symmetryBias) noexcept
+    {
+        auto shaped = tanhAmp * std::tanh(driven * tanhSlope) + sineAmp * std::sin(driven * sineFreq);
+        return asymmetrySample(driven, shaped, symmetryAmount, symmetryBias);
+    }
+
+    /**
+    * Applies the waveshaper function and the asymmetry to the (already driven) wet signal, in place and in a single pass
+    * 
+    * @param    channels the samples of every channel
+    * @param    numChannels the number of channels, at most maxNumChannels
+    * @param    numSamples the number of samples to process (oversampled, if oversampling is enabled)
+    */
+    void applyWaveshaper(float* const* channels, int numChannels, int numSamples);
+
+    // waveshaper parameters of a block during which none of them is smoothing
+    struct ShaperParameters {
+        float tanhAmp, tanhSlope, sineAmp, sineFreq, symmetryAmount, symmetryBias;
+    };
+    // one lane per channel, run on the worker pool
+    struct ShaperLanes {
+        std::array<float*, maxNumChannels> channels;
+        int numSamples;
+        ShaperParameters parameters;
+    };
+    static void shapeLane(void* context, int lane);
+    // below this (oversampled) block size waking a worker costs more than shaping the channel inline
+    static const int minSamplesPerLane = 256;
+    // the oversamplers are built again only when the number of channels changes
+    void initOversamplers(int numChannels, int samplesPerBlock);
+    // the shaper advances symmetry and bias once per oversampled sample: their ramps are sized at the oversampled rate,
+    // so that they last the same time at every oversampling factor
+    void resetShaperSmoothing(double sampleRate);
+    // length of the impulse response of the up and down sampling filters (latency included), measured once
+    static int measureOversamplerTail(juce::dsp::Oversampling<float>& os, int samplesPerBlock);
+
+    WaveshaperParameterHandles parameterHandles;
     bool bypassed = false;
-    juce::AudioBuffer<float> wetBuffer, tempBuffer;
     juce::LinearSmoothedValue<float> symmetry, bias;
     juce::LinearSmoothedValue<float> driveGain, dryGain, wetGain;
     juce::LinearSmoothedValue<float> tanhAmp, tanhSlope, sineAmp, sineFreq;
 
-    /*static const size_t numChannels = 2;
-    static const size_t oversamplingOrder = 4;
-    static const int    oversamplingFactor = 1 << oversamplingOrder;
-    static const auto filterType = juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR;
-
-    juce::dsp::Oversampling<float> oversampler{ numChannels, oversamplingOrder, filterType };*/
+    // one oversampler for every factor (2x to 16x) and filter type, all allocated in advance
+    static const int maxOversamplingOrder = 4;
+    std::array<std::unique_ptr<juce::dsp::Oversampling<float>>, 2 * maxOversamplingOrder> oversamplers;
+    // nullptr at 1x
+    juce::dsp::Oversampling<float>* oversampler = nullptr;
+    int oversamplerIndex = -1;
+    int oversamplersBlockSize = 0;
+    int oversamplersNumChannels = 0;
+    std::array<int, 2 * maxOversamplingOrder> oversamplerTails{};
+    // the dry signal is delayed by the oversampling latency to stay aligned with the wet one in the mix
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> dryDelay;
+    int latencySamples = 0;
 };
 
 //==============================================================================
@@ -157,6 +178,7 @@ private:
     using APVTS = juce::AudioProcessorValueTreeState;
     using Attachment = APVTS::SliderAttachment;
     using ButtonAttachment = APVTS::ButtonAttachment;
+    using ComboBoxAttachment = APVTS::ComboBoxAttachment;
 
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
@@ -190,6 +212,12 @@ private:
         sineAmpSliderAttachment,
         sineFreqSliderAttachment;
 
+    juce::ComboBox oversamplingBox, oversamplingFilterBox;
+    // created once the boxes are filled with the parameter choices
+    std::unique_ptr<ComboBoxAttachment> oversamplingBoxAttachment, oversamplingFilterBoxAttachment;
+    juce::ComboBox stereoModeBox;
+    std::unique_ptr<ComboBoxAttachment> stereoModeBoxAttachment;
+
     PowerButton bypassButton;
 
     ButtonAttachment bypassButtonAttachment;
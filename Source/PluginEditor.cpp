@@ -250,7 +250,7 @@ GUIModule* BiztortionAudioProcessorEditor::createGUIModule(ModuleType type, unsi
                 found = true;
             }
         }
-        newModule = new OscilloscopeModuleGUI(audioProcessor, oscilloscopeDSPModule->getLeftOscilloscope(), oscilloscopeDSPModule->getRightOscilloscope(), chainPosition);
+        newModule = new OscilloscopeModuleGUI(audioProcessor, oscilloscopeDSPModule, chainPosition);
         break;
     }
     case ModuleType::Waveshaper: {
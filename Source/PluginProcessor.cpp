@@ -51,10 +51,25 @@ BiztortionAudioProcessor::BiztortionAudioProcessor()
                        ), moduleTypes(var(juce::Array<juce::var>())), moduleChainPositions(var(juce::Array<juce::var>()))
 #endif
 {
+    // one pipeline stage per core the shared worker pool would give to the chain, the pool itself is only
+    // created when multicore processing is switched on
+    numPipelineStages = juce::jmin(DSPChain::maxPipelineStages, RealtimeWorkerPool::getDefaultNumWorkers() + 1);
+    multicoreProcessing = apvts.getRawParameterValue("Multicore Processing");
+    pipelinedProcessing = apvts.getRawParameterValue("Pipelined Processing");
+    updateWorkerPool();
+
     DSPModule* inputMeter = new MeterModuleDSP(apvts, "Input");
-    DSPmodules.push_back(std::unique_ptr<DSPModule>(inputMeter));
+    inputMeter->setScratchArena(getScratchArena(inputMeter->getChainPosition()));
+    inputMeter->setWorkerPool(&workerPool);
+    DSPmodules.push_back(std::shared_ptr<DSPModule>(inputMeter));
     DSPModule* outputMeter = new MeterModuleDSP(apvts, "Output");
-    DSPmodules.push_back(std::unique_ptr<DSPModule>(outputMeter));
+    outputMeter->setScratchArena(getScratchArena(outputMeter->getChainPosition()));
+    outputMeter->setWorkerPool(&workerPool);
+    DSPmodules.push_back(std::shared_ptr<DSPModule>(outputMeter));
+    // the meters, the 8 slots and the modules swapped by a drag and drop, so that the chain edits don't grow it
+    DSPmodules.reserve(12);
+    // the pooled modules own components and parameter listeners, so they are built here on the message thread
+    createModulePool();
 
     if (!apvts.state.hasProperty("moduleTypes")) {
         apvts.state.setProperty("moduleTypes", var(juce::Array<juce::var>()), nullptr);
@@ -66,10 +81,14 @@ BiztortionAudioProcessor::BiztortionAudioProcessor()
     }
     moduleChainPositions.referTo(apvts.state.getPropertyAsValue("moduleChainPositions", nullptr));
 
+    publishDSPChain();
+    // retired chain snapshots are deleted on the message thread
+    startTimerHz(10);
 }
 
 BiztortionAudioProcessor::~BiztortionAudioProcessor()
 {
+    stopTimer();
 }
 
 //==============================================================================
@@ -107,7 +126,8 @@ bool BiztortionAudioProcessor::isMidiEffect() const
 
 double BiztortionAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    auto sampleRate = getSampleRate();
+    return sampleRate > 0.0 ? chainTailSamples.load() / sampleRate : 0.0;
 }
 
 int BiztortionAudioProcessor::getNumPrograms()
@@ -140,10 +160,37 @@ void BiztortionAudioProcessor::prepareToPlay (double sampleRate, int samplesPerB
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
 
+    // the modules only see fixed sub-blocks and borrow their temporary buffers from the arena
+    subBlockSize = juce::jmin(samplesPerBlock, maxSubBlockSize);
+    // the modules process exactly the channels of the layout (a mono track costs half a stereo one)
+    numChannels = juce::jlimit(1, DSPModule::maxNumChannels, getTotalNumOutputChannels());
+    for (int stage = 0; stage < numPipelineStages; ++stage)
+        scratchArenas[(size_t)stage].prepare(numChannels, subBlockSize);
+    // pipelined processing collects sub-blocks, the delay of every stage is one sub-block
+    if (numPipelineStages > 1)
+        pipeline.prepare(numPipelineStages, numChannels, subBlockSize);
+    pipelined = numPipelineStages > 1 && pipelinedProcessing->load() > 0.5f && workerPool.load() != nullptr;
+    precisionConversionBuffer.setSize(numChannels, subBlockSize);
+
     // prepareToPlay for all the modules in the chain
+    int latency = 0;
     for (auto it = DSPmodules.cbegin(); it < DSPmodules.cend(); ++it) {
-        (**it).prepareToPlay(sampleRate, samplesPerBlock);
+        (**it).prepareToPlay(sampleRate, subBlockSize, numChannels);
+        latency += (**it).getLatencySamples();
+    }
+    // the modules not published yet are prepared too, the playback starts with them
+    modulesToIntroduce.clear();
+    // the pooled modules out of the chain get their buffers sized now, so that picking them up never allocates
+    for (auto& slot : modulePool) {
+        for (auto& module : slot) {
+            if (module != nullptr && std::find(DSPmodules.cbegin(), DSPmodules.cend(), module) == DSPmodules.cend())
+                module->prepareToPlay(sampleRate, subBlockSize, numChannels);
+        }
     }
+    if (pipelined)
+        latency += pipeline.getLatencySamples();
+    chainLatencySamples = latency;
+    setLatencySamples(latency);
 
     // fft analyzers
     for (auto it = leftAnalyzerFIFOs.cbegin(); it < leftAnalyzerFIFOs.cend(); ++it) {
@@ -177,12 +224,10 @@ bool BiztortionAudioProcessor::isBusesLayoutSupported (const BusesLayout& layout
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // every module processes the channels independently (with shared parameters),
+    // so any layout works, from mono up to DSPModule::maxNumChannels (e.g. 5.1 and 7.1)
+    const auto numOutputChannels = layouts.getMainOutputChannelSet().size();
+    if (layouts.getMainOutputChannelSet().isDisabled() || numOutputChannels > DSPModule::maxNumChannels)
         return false;
 
     // This checks if the input layout matches the output layout
@@ -197,6 +242,22 @@ bool BiztortionAudioProcessor::isBusesLayoutSupported (const BusesLayout& layout
 #endif
 
 void BiztortionAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processChain(buffer, midiMessages);
+}
+
+void BiztortionAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processChain(buffer, midiMessages);
+}
+
+bool BiztortionAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
+template <typename SampleType>
+void BiztortionAudioProcessor::processChain(juce::AudioBuffer<SampleType>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels  = getTotalNumInputChannels();
@@ -211,21 +272,51 @@ void BiztortionAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    if (!isSuspended()) {
-        // using a filter modules counter to find the right fft analyzer FIFO associated with the current filter
-        unsigned int filterModuleCounter = 0;
-        // processBlock for all the modules in the chain
-        for (auto it = DSPmodules.cbegin(); it < DSPmodules.cend(); ++it) {
-            auto module = &**it;
-            module->processBlock(buffer, midiMessages, getSampleRate());
-            auto filter = dynamic_cast<FilterModuleDSP*>(module);
-            // fft analyzers FIFOs update
-            if (filter) {
-                auto index = filterModuleCounter++;
-                leftAnalyzerFIFOs[index]->update(buffer);
-                rightAnalyzerFIFOs[index]->update(buffer);
+    // the most recent chain snapshot published by the message thread
+    auto chain = chainPublisher.getChainForAudioThread();
+
+    // nothing to process before prepareToPlay
+    if (chain != nullptr && subBlockSize > 0) {
+        // compiled chain: static dispatch per module type, analyzer FIFOs resolved when the snapshot was built.
+        // The host block (any size, even bigger than the prepared one) is sliced in fixed sub-blocks
+        // the pool of this block: the modules and the pipeline may see multicore processing switched off, never a dangling pool
+        auto* pool = workerPool.load(std::memory_order_acquire);
+        const auto pipelinedNow = numPipelineStages > 1 && pipelinedProcessing->load() > 0.5f && pool != nullptr;
+        if (pipelinedNow != pipelined) {
+            pipelined = pipelinedNow;
+            pipeline.reset();
+        }
+
+        int latency = 0;
+        const auto totalNumSamples = buffer.getNumSamples();
+        for (int start = 0; start < totalNumSamples; start += subBlockSize) {
+            const auto numSamples = juce::jmin(subBlockSize, totalNumSamples - start);
+            if constexpr (std::is_same_v<SampleType, float>) {
+                juce::AudioBuffer<float> subBuffer(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, numSamples);
+                latency = processSubBlock(*chain, pool, subBuffer, midiMessages);
+            }
+            else {
+                // double precision host: the chain runs in float, so the signal between the modules is float (the filters
+                // keep their states in double). The sub-block is converted once on the way in and once on the way out
+                const auto numConvertedChannels = juce::jmin(buffer.getNumChannels(), precisionConversionBuffer.getNumChannels());
+                juce::AudioBuffer<float> subBuffer(precisionConversionBuffer.getArrayOfWritePointers(), numConvertedChannels, numSamples);
+                for (int channel = 0; channel < numConvertedChannels; ++channel) {
+                    auto* hostData = buffer.getReadPointer(channel, start);
+                    auto* data = subBuffer.getWritePointer(channel);
+                    for (int i = 0; i < numSamples; ++i)
+                        data[i] = (float)hostData[i];
+                }
+                latency = processSubBlock(*chain, pool, subBuffer, midiMessages);
+                for (int channel = 0; channel < numConvertedChannels; ++channel) {
+                    auto* data = subBuffer.getReadPointer(channel);
+                    auto* hostData = buffer.getWritePointer(channel, start);
+                    for (int i = 0; i < numSamples; ++i)
+                        hostData[i] = data[i];
+                }
             }
         }
+        chainLatencySamples = latency;
+        chainTailSamples = chain->getTailSamples();
 
         // test signal
         /*buffer.clear();
@@ -235,6 +326,15 @@ void BiztortionAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, j
     }
 }
 
+int BiztortionAudioProcessor::processSubBlock(DSPChain& chain, RealtimeWorkerPool* pool, juce::AudioBuffer<float>& subBuffer, juce::MidiBuffer& midiMessages)
+{
+    if (pipelined && pool != nullptr) {
+        // the pipeline stages run on the workers
+        return pipeline.process(chain, *pool, subBuffer, midiMessages, getSampleRate()) + pipeline.getLatencySamples();
+    }
+    return chain.process(subBuffer, midiMessages, getSampleRate());
+}
+
 bool BiztortionAudioProcessor::hasEditor() const
 {
     return true; // (change this to false if you choose to not supply an editor)
@@ -288,10 +388,11 @@ void BiztortionAudioProcessor::setStateInformation(const void* data, int sizeInB
             jassertfalse;
         }
 
-        // restoring DSP modules
+        // restoring DSP modules, published all together
+        ScopedChainEdit chainEdit(*this);
         auto chainPosition = mcp->begin();
         for (auto type = mt->begin(); type < mt->end(); ++type) {
-            addAndSetupModuleForDSP(createDSPModule(static_cast<ModuleType>(int(*type))), int(*chainPosition));
+            addAndSetupModuleForDSP(static_cast<ModuleType>(int(*type)), int(*chainPosition));
             ++chainPosition;
         }
 
@@ -314,6 +415,13 @@ juce::AudioProcessorValueTreeState::ParameterLayout BiztortionAudioProcessor::cr
     BitcrusherModuleDSP::addParameters(layout);
     SlewLimiterModuleDSP::addParameters(layout);
 
+    // runs the independent lanes of the modules on worker threads shared by all the instances, off by default:
+    // the workers spin on their cores for a while after each block
+    layout.add(std::make_unique<juce::AudioParameterBool>("Multicore Processing", "Multicore Processing", false));
+    // processing mode, trades numPipelineStages sub-blocks of latency for multi-core throughput on heavy chains.
+    // Only with multicore processing on
+    layout.add(std::make_unique<juce::AudioParameterBool>("Pipelined Processing", "Pipelined Processing", false));
+
     return layout;
 }
 
@@ -347,18 +455,56 @@ DSPModule* BiztortionAudioProcessor::createDSPModule(ModuleType mt)
     return newModule;
 }
 
-void BiztortionAudioProcessor::addModuleToDSPmodules(DSPModule* module, unsigned int chainPosition)
+ScratchArena* BiztortionAudioProcessor::getScratchArena(unsigned int chainPosition)
+{
+    // the arena of the pipeline stage of the module, so that modules processed at the same time never share one
+    return &scratchArenas[(size_t)DSPChain::getPipelineStage(chainPosition, numPipelineStages)];
+}
+
+void BiztortionAudioProcessor::setupDSPModule(DSPModule& module, unsigned int chainPosition)
+{
+    module.setChainPosition(chainPosition);
+    module.setScratchArena(getScratchArena(chainPosition));
+    module.setWorkerPool(&workerPool);
+    module.setModuleType();
+}
+
+void BiztortionAudioProcessor::createModulePool()
+{
+    for (unsigned int chainPosition = 1; chainPosition <= modulePool.size(); ++chainPosition) {
+        for (auto type : { ModuleType::IIRFilter, ModuleType::Oscilloscope, ModuleType::Waveshaper, ModuleType::Bitcrusher, ModuleType::SlewLimiter }) {
+            auto module = std::shared_ptr<DSPModule>(createDSPModule(type));
+            setupDSPModule(*module, chainPosition);
+            modulePool[chainPosition - 1][(size_t)type] = module;
+        }
+    }
+}
+
+std::shared_ptr<DSPModule> BiztortionAudioProcessor::acquireDSPModule(ModuleType mt, unsigned int chainPosition)
+{
+    if (chainPosition >= 1 && chainPosition <= modulePool.size()) {
+        // the snapshots retired by the audio thread still reference the modules they processed
+        chainPublisher.collectGarbage();
+        auto& pooled = modulePool[chainPosition - 1][(size_t)mt];
+        // referenced by the pool only: neither in DSPmodules nor in a chain snapshot
+        if (pooled != nullptr && pooled.use_count() == 1)
+            return pooled;
+    }
+    // the pooled module is still in use (a drag and drop between two modules of the same type)
+    auto module = std::shared_ptr<DSPModule>(createDSPModule(mt));
+    setupDSPModule(*module, chainPosition);
+    return module;
+}
+
+void BiztortionAudioProcessor::addModuleToDSPmodules(std::shared_ptr<DSPModule> module, unsigned int chainPosition)
 {
-    // DSP module setup
-    module->setChainPosition(chainPosition);
-    module->setModuleType();
     // insert module to DSPmodules vector
     bool inserted = false;
     for (auto it = DSPmodules.begin(); !inserted; ++it) {
         // end = 8° grid cell
         if ((**it).getChainPosition() == 9) {
             inserted = true;
-            it = DSPmodules.insert(it, std::unique_ptr<DSPModule>(module));
+            it = DSPmodules.insert(it, module);
             continue;
         }
         // there is at least one module in the vector
@@ -366,25 +512,35 @@ void BiztortionAudioProcessor::addModuleToDSPmodules(DSPModule* module, unsigned
         ++next;
         if ((**it).getChainPosition() <= chainPosition && chainPosition < (**next).getChainPosition()) {
             inserted = true;
-            it = DSPmodules.insert(next, std::unique_ptr<DSPModule>(module));
+            it = DSPmodules.insert(next, module);
         }
         // else continue to iterate to find the right grid position
     }
     // module is a Filter => FIFO allocation for fft analyzer
-    if (dynamic_cast<FilterModuleDSP*>(module)) {
+    if (dynamic_cast<FilterModuleDSP*>(module.get())) {
         insertNewAnalyzerFIFO(chainPosition);
     }
 }
 
-void BiztortionAudioProcessor::addAndSetupModuleForDSP(DSPModule* module, unsigned int chainPosition)
+void BiztortionAudioProcessor::addAndSetupModuleForDSP(ModuleType mt, unsigned int chainPosition)
 {
-    // suspend audio processing
-    suspendProcessing(true);
+    auto module = acquireDSPModule(mt, chainPosition);
+    modulesToIntroduce.push_back(module.get());
     addModuleToDSPmodules(module, chainPosition);
-    // prepare to play the audio chain
-    prepareToPlay(getSampleRate(), getBlockSize());
-    // re-enable audio processing
-    suspendProcessing(false);
+    publishDSPChain();
+}
+
+void BiztortionAudioProcessor::introduceNewModules()
+{
+    // only the new modules need to be prepared, here on the message thread: the audio thread can't see them
+    // until the chain is published. They enter the running chain from the dry signal and fade in
+    if (getSampleRate() > 0.0 && subBlockSize > 0) {
+        for (auto* module : modulesToIntroduce) {
+            module->prepareToPlay(getSampleRate(), subBlockSize, numChannels);
+            module->fadeIn();
+        }
+    }
+    modulesToIntroduce.clear();
 }
 
 void BiztortionAudioProcessor::addDSPmoduleTypeAndPositionToAPVTS(ModuleType mt, unsigned int chainPosition)
@@ -411,14 +567,16 @@ void BiztortionAudioProcessor::removeModuleFromDSPmodules(unsigned int chainPosi
     for (auto it = DSPmodules.begin(); !found && it < DSPmodules.end(); ++it) {
         if ((**it).getChainPosition() == chainPosition) {
             found = true;
-            suspendProcessing(true);
             // remove fft analyzer FIFO associated with **it filter
             auto filter = dynamic_cast<FilterModuleDSP*>(&**it);
             if (filter) {
                 deleteOldAnalyzerFIFO(chainPosition);
             }
+            // a module added and removed in the same chain edit is never introduced
+            modulesToIntroduce.erase(std::remove(modulesToIntroduce.begin(), modulesToIntroduce.end(), &**it), modulesToIntroduce.end());
+            // the module is deleted with the last chain snapshot which references it
             it = DSPmodules.erase(it);
-            suspendProcessing(false);
+            publishDSPChain();
         }
     }
 }
@@ -468,8 +626,12 @@ unsigned int BiztortionAudioProcessor::getFftAnalyzerFifoIndexOfCorrespondingFil
 
 void BiztortionAudioProcessor::insertNewAnalyzerFIFO(unsigned int chainPosition)
 {
-    auto leftChannelFifo = new SingleChannelSampleFifo<BlockType>{ Channel::Left };
-    auto rightChannelFifo = new SingleChannelSampleFifo<BlockType>{ Channel::Right };
+    auto leftChannelFifo = std::make_shared<SingleChannelSampleFifo<BlockType>>(Channel::Left);
+    auto rightChannelFifo = std::make_shared<SingleChannelSampleFifo<BlockType>>(Channel::Right);
+    if (getBlockSize() > 0) {
+        leftChannelFifo->prepare(getBlockSize());
+        rightChannelFifo->prepare(getBlockSize());
+    }
     auto index = getFftAnalyzerFifoIndexOfCorrespondingFilter(chainPosition);
     if (leftAnalyzerFIFOs.empty()) {
         leftAnalyzerFIFOs.push_back(leftChannelFifo);
@@ -497,6 +659,55 @@ void BiztortionAudioProcessor::deleteOldAnalyzerFIFO(unsigned int chainPosition)
     rightAnalyzerFIFOs.erase(iteratorToDelete2);
 }
 
+void BiztortionAudioProcessor::publishDSPChain()
+{
+    // inside a chain edit the snapshot is published once, when the edit is over
+    if (chainEditDepth > 0)
+        return;
+
+    introduceNewModules();
+    auto chain = std::make_unique<DSPChain>();
+    chain->modules = DSPmodules;
+    chain->leftAnalyzerFIFOs = leftAnalyzerFIFOs;
+    chain->rightAnalyzerFIFOs = rightAnalyzerFIFOs;
+    chain->compile(numPipelineStages);
+    chainPublisher.publish(std::move(chain));
+}
+
+BiztortionAudioProcessor::ScopedChainEdit::ScopedChainEdit(BiztortionAudioProcessor& p)
+    : processor(p)
+{
+    ++processor.chainEditDepth;
+}
+
+BiztortionAudioProcessor::ScopedChainEdit::~ScopedChainEdit()
+{
+    jassert(processor.chainEditDepth > 0);
+    if (--processor.chainEditDepth == 0)
+        processor.publishDSPChain();
+}
+
+void BiztortionAudioProcessor::timerCallback()
+{
+    chainPublisher.collectGarbage();
+    updateWorkerPool();
+
+    // latency changes (oversampling mode, modules added or removed) are reported from here, not from the audio thread
+    auto latency = chainLatencySamples.load();
+    if (latency != getLatencySamples()) {
+        setLatencySamples(latency);
+    }
+}
+
+void BiztortionAudioProcessor::updateWorkerPool()
+{
+    const auto enabled = multicoreProcessing->load() > 0.5f;
+    if (enabled && sharedWorkerPool == nullptr)
+        sharedWorkerPool = std::make_unique<juce::SharedResourcePointer<RealtimeWorkerPool>>();
+    // switching off only hides the pool: it stays alive, so a block still running on it is safe
+    workerPool.store(enabled ? &sharedWorkerPool->get() : nullptr, std::memory_order_release);
+}
+
 //==============================================================================
 // This creates new instances of the plugin..
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
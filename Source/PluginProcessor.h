@@ -46,11 +46,13 @@ along with Biztortion. If not, see < http://www.gnu.org/licenses/>.
 #include "Module/OscilloscopeModule.h"
 #include "Component/ResponseCurveComponent.h"
 #include "Component/FFTAnalyzerComponent.h"
+#include "Shared/DSPChain.h"
+#include "Shared/ChainPipeline.h"
 
 //==============================================================================
 /**
 */
-class BiztortionAudioProcessor  : public juce::AudioProcessor
+class BiztortionAudioProcessor  : public juce::AudioProcessor, private juce::Timer
 {
 public:
     //==============================================================================
@@ -66,6 +68,8 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -100,23 +104,88 @@ public:
     // fft analyzers
     using BlockType = juce::AudioBuffer<float>;
     // analyzer FIFO allocated only if the relative module is istantiated
-    std::vector<SingleChannelSampleFifo<BlockType>*> leftAnalyzerFIFOs;
-    std::vector<SingleChannelSampleFifo<BlockType>*> rightAnalyzerFIFOs;
-    // modules
-    std::vector<std::unique_ptr<DSPModule>> DSPmodules;
+    std::vector<std::shared_ptr<SingleChannelSampleFifo<BlockType>>> leftAnalyzerFIFOs;
+    std::vector<std::shared_ptr<SingleChannelSampleFifo<BlockType>>> rightAnalyzerFIFOs;
+    // modules (edited only on the message thread, the audio thread processes the published DSPChain snapshot)
+    std::vector<std::shared_ptr<DSPModule>> DSPmodules;
 
     DSPModule* createDSPModule(ModuleType mt);
-    void addModuleToDSPmodules(DSPModule* module, unsigned int chainPosition);
-    void addAndSetupModuleForDSP(DSPModule* module, unsigned int chainPosition);
+    // the pooled module of the slot when no chain snapshot uses it, else a new one: set up for the slot either way
+    std::shared_ptr<DSPModule> acquireDSPModule(ModuleType mt, unsigned int chainPosition);
+    void addModuleToDSPmodules(std::shared_ptr<DSPModule> module, unsigned int chainPosition);
+    void addAndSetupModuleForDSP(ModuleType mt, unsigned int chainPosition);
     void addDSPmoduleTypeAndPositionToAPVTS(ModuleType mt, unsigned int chainPosition);
     void removeModuleFromDSPmodules(unsigned int chainPosition);
     void removeDSPmoduleTypeAndPositionFromAPVTS(unsigned int chainPosition);
     unsigned int getFftAnalyzerFifoIndexOfCorrespondingFilter(unsigned int chainPosition);
     void insertNewAnalyzerFIFO(unsigned int chainPosition);
     void deleteOldAnalyzerFIFO(unsigned int chainPosition);
+    void publishDSPChain();
+
+    // batches the chain edits of its scope (a drag and drop adds and removes up to four modules):
+    // the new modules are prepared and the chain is published once, when the outermost edit is over
+    struct ScopedChainEdit {
+        explicit ScopedChainEdit(BiztortionAudioProcessor& p);
+        ~ScopedChainEdit();
+
+        BiztortionAudioProcessor& processor;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedChainEdit)
+    };
 
 private:
 
+    void timerCallback() override;
+
+    // the float and double processBlock
+    template <typename SampleType>
+    void processChain(juce::AudioBuffer<SampleType>& buffer, juce::MidiBuffer& midiMessages);
+    // one sub-block through the chain (or the pipeline, on pool when it is not null), returns the latency
+    int processSubBlock(DSPChain& chain, RealtimeWorkerPool* pool, juce::AudioBuffer<float>& subBuffer, juce::MidiBuffer& midiMessages);
+
+    DSPChainPublisher chainPublisher;
+    // temporary buffers borrowed by the modules, one per pipeline stage (the stages may run at the same time), sized once in prepareToPlay
+    std::array<ScratchArena, DSPChain::maxPipelineStages> scratchArenas;
+    ScratchArena* getScratchArena(unsigned int chainPosition);
+    // workers running the independent lanes of the modules and the pipeline stages, shared by all the instances.
+    // Acquired on the message thread the first time multicore processing is switched on, kept until the processor goes
+    std::unique_ptr<juce::SharedResourcePointer<RealtimeWorkerPool>> sharedWorkerPool;
+    // the shared pool while multicore processing is on, null otherwise (read by the audio thread and the modules)
+    std::atomic<RealtimeWorkerPool*> workerPool{ nullptr };
+    std::atomic<float>* multicoreProcessing = nullptr;
+    // message thread: follows the multicore processing parameter
+    void updateWorkerPool();
+    // pipelined processing: the chain is split in numPipelineStages running on different cores (1 = not available),
+    // it needs multicore processing
+    int numPipelineStages = 1;
+    ChainPipeline pipeline;
+    std::atomic<float>* pipelinedProcessing = nullptr;
+    // audio thread: mode of the previous block, the pipeline is emptied when it changes
+    bool pipelined = false;
+    // the chain always runs on sub-blocks of at most maxSubBlockSize samples, whatever the host buffer size:
+    // the parameters are updated once per sub-block and the working set stays in L1 cache
+    static constexpr int maxSubBlockSize = 64;
+    // block size the modules are prepared with (0 before prepareToPlay)
+    int subBlockSize = 0;
+    // channels the modules are prepared with: the main bus layout, mono up to DSPModule::maxNumChannels
+    int numChannels = 0;
+    // double precision hosts: the sub-block being processed, converted to float
+    juce::AudioBuffer<float> precisionConversionBuffer;
+    // sum of the modules latencies, written by the audio thread and reported to the host by the timer
+    std::atomic<int> chainLatencySamples{ 0 };
+    // sum of the modules tails, written by the audio thread and reported by getTailLengthSeconds
+    std::atomic<int> chainTailSamples{ 0 };
+    // message thread: nesting of the ScopedChainEdits
+    int chainEditDepth = 0;
+    // modules added since the last publish, prepared and faded in right before the next one
+    std::vector<DSPModule*> modulesToIntroduce;
+    void introduceNewModules();
+    // one module per type per slot (1 - 8), indexed by ModuleType: built with the processor and prepared in prepareToPlay,
+    // so that the chain edits reuse them instead of allocating a module and its buffers
+    std::array<std::array<std::shared_ptr<DSPModule>, ModuleType::SlewLimiter + 1>, 8> modulePool;
+    void createModulePool();
+    void setupDSPModule(DSPModule& module, unsigned int chainPosition);
+
     // test signal
     // juce::dsp::Oscillator<float> osc;
 
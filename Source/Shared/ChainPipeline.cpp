@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    ChainPipeline.cpp
+
+    Copyright (c) 2021 KillBizz - Gabriel Bizzo
+
+  ==============================================================================
+*/
+
+/*
+
+This file is part of Biztortion software.
+
+Biztortion is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Biztortion is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Biztortion. If not, see < http://www.gnu.org/licenses/>.
+
+*/
+#include "ChainPipeline.h"
+
+void ChainPipeline::prepare(int stagesCount, int numChannels, int size)
+{
+    jassert(stagesCount >= 1 && stagesCount <= DSPChain::maxPipelineStages);
+    numStages = juce::jlimit(1, DSPChain::maxPipelineStages, stagesCount);
+    blockSize = size;
+    slots.resize((size_t)numStages);
+    for (auto& slot : slots)
+        slot.setSize(numChannels, blockSize);
+    reset();
+}
+
+void ChainPipeline::reset() noexcept
+{
+    for (auto& slot : slots)
+        slot.clear();
+    inputSlot = 0;
+    position = 0;
+    stageLatencies.fill(0);
+    chainLatency = 0;
+}
+
+int ChainPipeline::process(DSPChain& chain, RealtimeWorkerPool& pool, juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, double sampleRate) noexcept
+{
+    if (numStages == 0 || blockSize == 0)
+        return chainLatency;
+
+    const auto numChannels = juce::jmin(buffer.getNumChannels(), slots[0].getNumChannels());
+    const auto totalNumSamples = buffer.getNumSamples();
+    for (int start = 0; start < totalNumSamples;) {
+        const auto numSamples = juce::jmin(blockSize - position, totalNumSamples - start);
+        // the input slot holds the block that left the last stage: the host gets it, the slot gets the new samples
+        auto& slot = slots[(size_t)inputSlot];
+        for (int channel = 0; channel < numChannels; ++channel) {
+            auto* hostData = buffer.getWritePointer(channel, start);
+            std::swap_ranges(hostData, hostData + numSamples, slot.getWritePointer(channel, position));
+        }
+        start += numSamples;
+        position += numSamples;
+
+        if (position == blockSize) {
+            runCycle(chain, pool, midiMessages, sampleRate);
+            position = 0;
+        }
+    }
+    return chainLatency;
+}
+
+void ChainPipeline::runCycle(DSPChain& chain, RealtimeWorkerPool& pool, juce::MidiBuffer& midiMessages, double sampleRate) noexcept
+{
+    jassert(chain.numPipelineStages == numStages);
+    currentChain = &chain;
+    currentMidiMessages = &midiMessages;
+    currentSampleRate = sampleRate;
+    pool.run(numStages, &ChainPipeline::runStage, this);
+
+    chainLatency = 0;
+    for (int stage = 0; stage < numStages; ++stage)
+        chainLatency += stageLatencies[(size_t)stage];
+    // the slot that just left the last stage receives the next block
+    inputSlot = (inputSlot + 1) % numStages;
+}
+
+void ChainPipeline::runStage(void* context, int lane)
+{
+    auto& pipeline = *static_cast<ChainPipeline*>(context);
+    // stage s works on the block collected s cycles ago
+    const auto slot = (pipeline.inputSlot - lane + pipeline.numStages) % pipeline.numStages;
+    pipeline.stageLatencies[(size_t)lane] = lane < pipeline.currentChain->numPipelineStages
+        ? pipeline.currentChain->processPipelineStage(lane, pipeline.slots[(size_t)slot], *pipeline.currentMidiMessages, pipeline.currentSampleRate)
+        : 0;
+}
@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    ChainPipeline.h
+
+    Copyright (c) 2021 KillBizz - Gabriel Bizzo
+
+  ==============================================================================
+*/
+
+/*
+
+This file is part of Biztortion software.
+
+Biztortion is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Biztortion is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Biztortion. If not, see < http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+#include "DSPChain.h"
+#include "RealtimeWorkerPool.h"
+
+//==============================================================================
+
+/* ChainPipeline */
+
+//==============================================================================
+
+/**
+* Runs the pipeline stages of a DSPChain on different cores: while block N goes through the
+* modules of stage 1, block N + 1 goes through the ones of stage 0, and so on.
+* The blocks are collected from the host buffer at a fixed size, so the pipeline delays the
+* signal by numStages blocks (getLatencySamples) whatever the host buffer size.
+* Every block travels in its own slot: the slot leaving the last stage is swapped with the
+* incoming samples, so no other buffer is needed.
+*/
+class ChainPipeline {
+public:
+    ChainPipeline() = default;
+
+    // not thread safe: call it only while the audio thread is not processing
+    void prepare(int numStages, int numChannels, int blockSize);
+    // audio thread: empties the pipeline, the next getLatencySamples() samples are silent
+    void reset() noexcept;
+
+    int getNumStages() const noexcept { return numStages; }
+    int getLatencySamples() const noexcept { return numStages * blockSize; }
+
+    /**
+    * Audio thread: replaces the buffer with the chain output of getLatencySamples() samples ago.
+    *
+    * @param    chain the snapshot to process, compiled with the same number of stages
+    * @param    pool the workers running the stages, it should have at least numStages - 1 of them
+    * @param    buffer the host buffer, any size
+    * @return   the latency of the chain modules (the pipeline one not included)
+    */
+    int process(DSPChain& chain, RealtimeWorkerPool& pool, juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, double sampleRate) noexcept;
+
+private:
+    // every stage processes its slot, once a full block has been collected
+    void runCycle(DSPChain& chain, RealtimeWorkerPool& pool, juce::MidiBuffer& midiMessages, double sampleRate) noexcept;
+    static void runStage(void* context, int lane);
+
+    std::vector<juce::AudioBuffer<float>> slots;
+    int numStages = 0;
+    int blockSize = 0;
+    // slot being filled by the host samples (processed by stage 0 in the next cycle)
+    int inputSlot = 0;
+    // samples of the current block already collected
+    int position = 0;
+
+    // the running cycle, read by the lanes
+    DSPChain* currentChain = nullptr;
+    juce::MidiBuffer* currentMidiMessages = nullptr;
+    double currentSampleRate = 0.0;
+    std::array<int, DSPChain::maxPipelineStages> stageLatencies{};
+    int chainLatency = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(ChainPipeline)
+};
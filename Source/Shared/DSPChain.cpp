@@ -0,0 +1,346 @@
+/*
+  ==============================================================================
+
+    DSPChain.cpp
+
+    Copyright (c) 2021 KillBizz - Gabriel Bizzo
+
+  ==============================================================================
+*/
+
+/*
+
+This file is part of Biztortion software.
+
+Biztortion is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Biztortion is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Biztortion. If not, see < http://www.gnu.org/licenses/>.
+
+*/
+
+#include "DSPChain.h"
+
+#include "../Module/MeterModule.h"
+#include "../Module/FilterModule.h"
+#include "../Module/WaveshaperModule.h"
+#include "../Module/BitcrusherModule.h"
+#include "../Module/SlewLimiterModule.h"
+#include "../Module/OscilloscopeModule.h"
+
+//==============================================================================
+
+/* DSPChain */
+
+//==============================================================================
+
+namespace {
+    // qualified calls on the concrete type: no virtual dispatch in the hot loop
+    template <typename ModuleDSP>
+    int processStage(DSPModule* module, juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, double sampleRate)
+    {
+        auto* concrete = static_cast<ModuleDSP*>(module);
+        concrete->ModuleDSP::processBlock(buffer, midiMessages, sampleRate);
+        return concrete->ModuleDSP::getLatencySamples();
+    }
+
+    // processing slots: the first two channels are encoded to mid/side once at the input of the module and
+    // decoded at its output. Mid only / side only pass the module one lane (plus the surround channels),
+    // so it doesn't spend anything on the other one, which is only delayed by the module latency.
+    // The lane of a channel then depends on the mode: the module clears its channel state when the mode changes
+    template <typename ModuleDSP>
+    int processStereoStage(DSPModule* module, juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, double sampleRate)
+    {
+        const auto mode = module->getStereoMode();
+        const auto numChannels = juce::jmin(buffer.getNumChannels(), DSPModule::maxNumChannels);
+        if (numChannels >= 2)
+            module->setLaneStereoMode(mode);
+        if (mode == StereoMode::LeftRight || numChannels < 2)
+            return processStage<ModuleDSP>(module, buffer, midiMessages, sampleRate);
+
+        const auto numSamples = buffer.getNumSamples();
+        auto* left = buffer.getWritePointer(0);
+        auto* right = buffer.getWritePointer(1);
+        for (int i = 0; i < numSamples; ++i) {
+            const auto mid = 0.5f * (left[i] + right[i]);
+            const auto side = 0.5f * (left[i] - right[i]);
+            left[i] = mid;
+            right[i] = side;
+        }
+
+        int latency;
+        if (mode == StereoMode::MidSide) {
+            latency = processStage<ModuleDSP>(module, buffer, midiMessages, sampleRate);
+        }
+        else {
+            const int lane = mode == StereoMode::MidOnly ? 0 : 1;
+            std::array<float*, DSPModule::maxNumChannels> channels{};
+            channels[0] = buffer.getWritePointer(lane);
+            for (int channel = 2; channel < numChannels; ++channel)
+                channels[(size_t)channel - 1] = buffer.getWritePointer(channel);
+            juce::AudioBuffer<float> laneBuffer(channels.data(), numChannels - 1, numSamples);
+            latency = processStage<ModuleDSP>(module, laneBuffer, midiMessages, sampleRate);
+            module->delaySkippedLane(buffer.getWritePointer(1 - lane), numSamples, latency);
+        }
+
+        for (int i = 0; i < numSamples; ++i) {
+            const auto mid = left[i];
+            const auto side = right[i];
+            left[i] = mid + side;
+            right[i] = mid - side;
+        }
+        return latency;
+    }
+
+    // stops at the first sample above the threshold: a loud block costs one comparison
+    bool isSilent(const juce::AudioBuffer<float>& buffer) noexcept
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+            auto* data = buffer.getReadPointer(channel);
+            for (int i = 0; i < buffer.getNumSamples(); ++i) {
+                if (std::abs(data[i]) > DSPModule::silenceThreshold)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    // silence of the buffer between two stages, checked only when a sleeping stage asks for it
+    struct Silence {
+        bool known = false;
+        bool silent = false;
+
+        bool check(const juce::AudioBuffer<float>& buffer) noexcept
+        {
+            if (!known) {
+                silent = isSilent(buffer);
+                known = true;
+            }
+            return silent;
+        }
+    };
+
+    // processing slots sleep while their input is silent and their tail is over: the (silent) buffer goes
+    // through untouched and the module costs nothing. A processed block makes the silence unknown again
+    template <typename ModuleDSP>
+    int processSleepingStage(DSPModule* module, juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, double sampleRate, Silence& silence)
+    {
+        if (module->canSleep(silence.check(buffer), buffer.getNumSamples()))
+            return static_cast<ModuleDSP*>(module)->ModuleDSP::getLatencySamples();
+
+        const auto latency = processStereoStage<ModuleDSP>(module, buffer, midiMessages, sampleRate);
+        silence.known = false;
+        return latency;
+    }
+}
+
+int DSPChain::getPipelineStage(unsigned int chainPosition, int numPipelineStages) noexcept
+{
+    // position 0 = input meter, 1 - 8 = chain slots, 9 = output meter
+    return juce::jlimit(0, numPipelineStages - 1, ((int)chainPosition - 1) * numPipelineStages / 8);
+}
+
+void DSPChain::compile(int pipelineStagesCount)
+{
+    jassert(pipelineStagesCount >= 1 && pipelineStagesCount <= maxPipelineStages);
+    numPipelineStages = juce::jlimit(1, maxPipelineStages, pipelineStagesCount);
+
+    stages.clear();
+    stages.reserve(modules.size());
+    // filters are linked to their analyzer FIFOs in chain order
+    size_t filterCounter = 0;
+    for (auto& module : modules) {
+        Stage stage;
+        stage.type = module->getModuleType();
+        stage.module = module.get();
+        if (stage.type == ModuleType::IIRFilter) {
+            auto index = filterCounter++;
+            jassert(index < leftAnalyzerFIFOs.size() && index < rightAnalyzerFIFOs.size());
+            if (index < leftAnalyzerFIFOs.size() && index < rightAnalyzerFIFOs.size()) {
+                stage.leftAnalyzerFifo = leftAnalyzerFIFOs[index].get();
+                stage.rightAnalyzerFifo = rightAnalyzerFIFOs[index].get();
+            }
+        }
+        stages.push_back(stage);
+    }
+
+    // the modules are sorted by chain position, so every pipeline stage is a contiguous range of stages
+    pipelineBounds.fill(stages.size());
+    pipelineBounds[0] = 0;
+    for (int pipelineStage = 1; pipelineStage < numPipelineStages; ++pipelineStage) {
+        size_t bound = pipelineBounds[(size_t)pipelineStage - 1];
+        while (bound < stages.size() && getPipelineStage(modules[bound]->getChainPosition(), numPipelineStages) < pipelineStage)
+            ++bound;
+        pipelineBounds[(size_t)pipelineStage] = bound;
+    }
+
+    // two idle flags per stage in ActivePlan::idleFlags
+    jassert(stages.size() <= 32);
+    for (auto& plan : activePlans) {
+        plan = ActivePlan();
+        plan.steps.reserve(stages.size());
+    }
+}
+
+int DSPChain::process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, double sampleRate) noexcept
+{
+    return processStages(activePlans[0], 0, stages.size(), buffer, midiMessages, sampleRate);
+}
+
+int DSPChain::processPipelineStage(int pipelineStage, juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, double sampleRate) noexcept
+{
+    jassert(pipelineStage >= 0 && pipelineStage < numPipelineStages);
+    return processStages(activePlans[(size_t)pipelineStage], pipelineBounds[(size_t)pipelineStage], pipelineBounds[(size_t)pipelineStage + 1], buffer, midiMessages, sampleRate);
+}
+
+int DSPChain::getTailSamples() noexcept
+{
+    int tail = 0;
+    for (auto& stage : stages)
+        tail += stage.module->getTailSamples();
+    return tail;
+}
+
+void DSPChain::updateActivePlan(ActivePlan& plan, size_t begin, size_t end) noexcept
+{
+    juce::uint64 idleFlags = 0;
+    for (auto index = begin; index < end; ++index) {
+        auto& stage = stages[index];
+        auto idle = stage.module->isIdle();
+        // a bypassed filter is still processed while its analyzer is showing
+        if (idle && stage.leftAnalyzerFifo != nullptr)
+            idle = !stage.leftAnalyzerFifo->isArmed() && !stage.rightAnalyzerFifo->isArmed();
+        if (idle) {
+            const auto shift = 2 * (index - begin);
+            idleFlags |= (juce::uint64)1 << shift;
+            if (stage.module->getLatencySamples() > 0)
+                idleFlags |= (juce::uint64)2 << shift;
+        }
+    }
+    if (plan.built && plan.begin == begin && plan.end == end && plan.idleFlags == idleFlags)
+        return;
+
+    plan.begin = begin;
+    plan.end = end;
+    plan.idleFlags = idleFlags;
+    plan.built = true;
+    plan.steps.clear();
+    for (auto index = begin; index < end; ++index) {
+        const auto flags = (idleFlags >> (2 * (index - begin))) & 3;
+        // idle and without latency: the module costs nothing at all
+        if (flags == 1)
+            continue;
+        ActivePlan::Step step;
+        step.stage = index;
+        step.idle = flags != 0;
+        plan.steps.push_back(step);
+    }
+}
+
+int DSPChain::processStages(ActivePlan& plan, size_t begin, size_t end, juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, double sampleRate) noexcept
+{
+    updateActivePlan(plan, begin, end);
+
+    int latency = 0;
+    // the meters and the oscilloscopes don't change the signal, so they never clear this
+    Silence silence;
+    for (const auto& step : plan.steps) {
+        auto& stage = stages[step.stage];
+        if (step.idle) {
+            // only the latency delay is left, which may still be letting out the sound before the silence
+            stage.module->processIdle(buffer);
+            latency += stage.module->getLatencySamples();
+            silence.known = false;
+            continue;
+        }
+        switch (stage.type) {
+        case ModuleType::Meter:
+            latency += processStage<MeterModuleDSP>(stage.module, buffer, midiMessages, sampleRate);
+            break;
+        case ModuleType::IIRFilter: {
+            latency += processSleepingStage<FilterModuleDSP>(stage.module, buffer, midiMessages, sampleRate, silence);
+            // fft analyzers FIFOs update, only for the analyzers that are enabled and showing
+            if (stage.leftAnalyzerFifo != nullptr && static_cast<FilterModuleDSP*>(stage.module)->isAnalyzerEnabled()) {
+                if (stage.leftAnalyzerFifo->isArmed())
+                    stage.leftAnalyzerFifo->update(buffer);
+                if (stage.rightAnalyzerFifo->isArmed())
+                    stage.rightAnalyzerFifo->update(buffer);
+            }
+            break;
+        }
+        case ModuleType::Oscilloscope:
+            latency += processStage<OscilloscopeModuleDSP>(stage.module, buffer, midiMessages, sampleRate);
+            break;
+        case ModuleType::Waveshaper:
+            latency += processSleepingStage<WaveshaperModuleDSP>(stage.module, buffer, midiMessages, sampleRate, silence);
+            break;
+        case ModuleType::Bitcrusher:
+            latency += processSleepingStage<BitcrusherModuleDSP>(stage.module, buffer, midiMessages, sampleRate, silence);
+            break;
+        case ModuleType::SlewLimiter:
+            latency += processSleepingStage<SlewLimiterModuleDSP>(stage.module, buffer, midiMessages, sampleRate, silence);
+            break;
+        default:
+            // not reachable: every module type is set before publishing
+            stage.module->processBlock(buffer, midiMessages, sampleRate);
+            latency += stage.module->getLatencySamples();
+            break;
+        }
+    }
+    return latency;
+}
+
+//==============================================================================
+
+/* DSPChainPublisher */
+
+//==============================================================================
+
+DSPChainPublisher::~DSPChainPublisher()
+{
+    // the audio thread is stopped when the processor is destroyed
+    collectGarbage();
+    delete pendingChain.exchange(nullptr);
+    delete liveChain;
+}
+
+void DSPChainPublisher::publish(std::unique_ptr<DSPChain> chain)
+{
+    // a snapshot still pending has never been seen by the audio thread, so it can be deleted right away
+    delete pendingChain.exchange(chain.release(), std::memory_order_acq_rel);
+    collectGarbage();
+}
+
+void DSPChainPublisher::collectGarbage()
+{
+    const juce::ScopedLock sl(garbageLock);
+    const auto read = retiredFifo.read(retiredFifo.getNumReady());
+    read.forEach([this](int index) {
+        delete retiredChains[(size_t)index];
+        retiredChains[(size_t)index] = nullptr;
+    });
+}
+
+DSPChain* DSPChainPublisher::getChainForAudioThread() noexcept
+{
+    // the swap is postponed while there is no room to retire the current snapshot
+    if (pendingChain.load(std::memory_order_relaxed) != nullptr && retiredFifo.getFreeSpace() > 0) {
+        if (auto* next = pendingChain.exchange(nullptr, std::memory_order_acq_rel)) {
+            if (liveChain != nullptr) {
+                const auto write = retiredFifo.write(1);
+                jassert(write.blockSize1 == 1);
+                retiredChains[(size_t)write.startIndex1] = liveChain;
+            }
+            liveChain = next;
+        }
+    }
+    return liveChain;
+}
@@ -0,0 +1,146 @@
+/*
+  ==============================================================================
+
+    DSPChain.h
+
+    Copyright (c) 2021 KillBizz - Gabriel Bizzo
+
+  ==============================================================================
+*/
+
+/*
+
+This file is part of Biztortion software.
+
+Biztortion is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Biztortion is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Biztortion. If not, see < http://www.gnu.org/licenses/>.
+
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include "../Module/DSPModule.h"
+#include "FFTAnalyzer.h"
+
+//==============================================================================
+
+/* DSPChain */
+
+//==============================================================================
+
+// immutable snapshot of the processing chain: built on the message thread, read by the audio thread
+struct DSPChain {
+    using AnalyzerFifo = SingleChannelSampleFifo<juce::AudioBuffer<float>>;
+
+    // the chain can be split in at most this many pipeline stages (see ChainPipeline)
+    static constexpr int maxPipelineStages = 4;
+    // pipeline stage of a chain position: the 8 slots are split evenly, the input meter goes
+    // in the first stage and the output meter in the last one
+    static int getPipelineStage(unsigned int chainPosition, int numPipelineStages) noexcept;
+
+    // one compiled step of the chain: the module type selects a statically dispatched process function
+    struct Stage {
+        ModuleType type = ModuleType::Uninstantiated;
+        DSPModule* module = nullptr;
+        // left/right analyzer FIFOs fed after this stage (filters only)
+        AnalyzerFifo* leftAnalyzerFifo = nullptr;
+        AnalyzerFifo* rightAnalyzerFifo = nullptr;
+    };
+
+    // modules sorted by chain position (input meter first, output meter last)
+    std::vector<std::shared_ptr<DSPModule>> modules;
+    // one FIFO per filter module, in the same order of the filters in the chain
+    std::vector<std::shared_ptr<AnalyzerFifo>> leftAnalyzerFIFOs;
+    std::vector<std::shared_ptr<AnalyzerFifo>> rightAnalyzerFIFOs;
+
+    // contiguous copy of modules resolved by compile(), the only thing walked by the audio thread
+    std::vector<Stage> stages;
+    // stages[pipelineBounds[s], pipelineBounds[s + 1]) are the modules of pipeline stage s
+    int numPipelineStages = 1;
+    std::array<size_t, maxPipelineStages + 1> pipelineBounds{};
+
+    // what a range of stages actually runs: the idle modules (see DSPModule::isIdle) are left out, or only delay
+    // the signal when they have latency. Rebuilt by the thread processing the range only when an idle flag changes
+    struct ActivePlan {
+        struct Step {
+            size_t stage = 0;
+            bool idle = false;
+        };
+        // range of stages the plan was built for
+        size_t begin = 0, end = 0;
+        // two bits per stage of the range: idle, idle with latency
+        juce::uint64 idleFlags = 0;
+        bool built = false;
+        // capacity reserved by compile(), so that rebuilding never allocates
+        std::vector<Step> steps;
+    };
+    // the plan of every pipeline stage, the first one is also the plan of the whole chain
+    std::array<ActivePlan, maxPipelineStages> activePlans;
+
+    // message thread: resolves module types and filter -> analyzer FIFO links once per snapshot
+    void compile(int numPipelineStages = 1);
+    // audio thread: processes the buffer through every stage, returns the latency of the chain
+    int process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, double sampleRate) noexcept;
+    // audio thread or pipeline worker: processes the buffer through the modules of one pipeline stage only
+    int processPipelineStage(int pipelineStage, juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, double sampleRate) noexcept;
+    // audio thread: sum of the tails of the modules, in samples
+    int getTailSamples() noexcept;
+
+private:
+    // audio thread or pipeline worker: updates the plan of [begin, end) if an idle flag changed since the last block
+    void updateActivePlan(ActivePlan& plan, size_t begin, size_t end) noexcept;
+    int processStages(ActivePlan& plan, size_t begin, size_t end, juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, double sampleRate) noexcept;
+};
+
+//==============================================================================
+
+/* DSPChainPublisher */
+
+//==============================================================================
+
+/**
+* Hands DSPChain snapshots over to the audio thread with an atomic pointer swap.
+* The audio thread never allocates, locks or deletes: the snapshot it stops using is queued
+* in a lock-free FIFO and deleted later on the message thread by collectGarbage().
+*/
+class DSPChainPublisher {
+public:
+    DSPChainPublisher() = default;
+    ~DSPChainPublisher();
+
+    // message thread: makes chain the next snapshot picked up by the audio thread
+    void publish(std::unique_ptr<DSPChain> chain);
+    // message thread: deletes the snapshots retired by the audio thread
+    void collectGarbage();
+
+    // audio thread: returns the most recent published snapshot (nullptr before the first publish)
+    DSPChain* getChainForAudioThread() noexcept;
+
+private:
+    static constexpr int retiredCapacity = 32;
+
+    std::atomic<DSPChain*> pendingChain{ nullptr };
+    // owned by the audio thread
+    DSPChain* liveChain = nullptr;
+
+    juce::AbstractFifo retiredFifo{ retiredCapacity };
+    std::array<DSPChain*, retiredCapacity> retiredChains{};
+    // serializes the consumers of retiredFifo (never taken by the audio thread)
+    juce::CriticalSection garbageLock;
+
+    JUCE_DECLARE_NON_COPYABLE(DSPChainPublisher)
+};
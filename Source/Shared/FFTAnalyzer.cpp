@@ -48,21 +48,17 @@ PathProducer::PathProducer(SingleChannelSampleFifo<juce::AudioBuffer<float>>& sc
 
 void PathProducer::process(juce::Rectangle<float> fftBounds, double sampleRate)
 {
-    juce::AudioBuffer<float> tempIncomingBuffer;
+    const auto monoSize = monoBuffer.getNumSamples();
     while (leftChannelFifo->getNumCompleteBuffersAvailable() > 0) {
-        if (leftChannelFifo->getAudioBuffer(tempIncomingBuffer)) {
-            // notice that with these operations monoBuffer never changes size
-            auto size = tempIncomingBuffer.getNumSamples();
-            // left shifting of audio data in the buffer (losting the first block)
-            juce::FloatVectorOperations::copy(
-                monoBuffer.getWritePointer(0, 0),
-                monoBuffer.getReadPointer(0, size - 1),
-                monoBuffer.getNumSamples() - size);
-            // appending fresh audio data block in the buffer
-            juce::FloatVectorOperations::copy(
-                monoBuffer.getWritePointer(0, monoBuffer.getNumSamples() - size),
-                tempIncomingBuffer.getReadPointer(0, 0),
-                size);
+        // notice that with these operations monoBuffer never changes size
+        auto size = juce::jmin(leftChannelFifo->getSize(), monoSize);
+        // left shifting of audio data in the buffer (losting the first block), the ranges overlap
+        if (size < monoSize)
+            std::memmove(monoBuffer.getWritePointer(0, 0),
+                monoBuffer.getReadPointer(0, size),
+                (size_t)(monoSize - size) * sizeof(float));
+        // appending fresh audio data block in the buffer, straight from the ring
+        if (leftChannelFifo->getSamples(monoBuffer.getWritePointer(0, monoSize - size), size)) {
             // negativeInfinity = minimum magnitude value to display in the analyzer
             leftChannelFFTDataGenerator.produceFFTDataForRendering(monoBuffer, -48.f);
         }
@@ -41,6 +41,7 @@ along with Biztortion. If not, see < http://www.gnu.org/licenses/>.
 
 #include <JuceHeader.h>
 #include <array>
+#include <cstring>
 
 enum Channel {
     Right, // 0
@@ -111,6 +112,58 @@ private:
     juce::AbstractFifo fifo{ Capacity };
 };
 
+// lock-free single-producer/single-consumer ring of samples, written and read in bulk
+struct SampleRing
+{
+    // not thread safe: call it only while neither the producer nor the consumer are running
+    void prepare(int capacity)
+    {
+        samples.assign((size_t)capacity + 1, 0.f);
+        fifo.setTotalSize(capacity + 1);
+        fifo.reset();
+    }
+
+    // writes as many samples as there is room for, the rest is dropped
+    int push(const float* data, int numSamples)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+        if (size1 > 0)
+            std::memcpy(samples.data() + start1, data, (size_t)size1 * sizeof(float));
+        if (size2 > 0)
+            std::memcpy(samples.data() + start2, data + size1, (size_t)size2 * sizeof(float));
+        fifo.finishedWrite(size1 + size2);
+        return size1 + size2;
+    }
+
+    // reads exactly numSamples samples, or nothing if they are not available yet
+    bool pull(float* data, int numSamples)
+    {
+        if (fifo.getNumReady() < numSamples)
+            return false;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(numSamples, start1, size1, start2, size2);
+        if (size1 > 0)
+            std::memcpy(data, samples.data() + start1, (size_t)size1 * sizeof(float));
+        if (size2 > 0)
+            std::memcpy(data + size1, samples.data() + start2, (size_t)size2 * sizeof(float));
+        fifo.finishedRead(size1 + size2);
+        return true;
+    }
+
+    // consumer side: drops everything written so far
+    void discard()
+    {
+        fifo.finishedRead(fifo.getNumReady());
+    }
+
+    int getNumReady() const { return fifo.getNumReady(); }
+private:
+    std::vector<float> samples;
+    juce::AbstractFifo fifo{ 1 };
+};
+
 // produces single-channel blocks of fixed amount audio samples
 template<typename BlockType>
 struct SingleChannelSampleFifo
@@ -120,61 +173,58 @@ struct SingleChannelSampleFifo
         prepared.set(false);
     }
 
+    // the audio thread feeds the FIFO only while at least one consumer (a showing analyzer) is armed
+    bool isArmed() const { return consumers.load(std::memory_order_relaxed) > 0; }
+    // consumer (GUI) thread
+    void arm()
+    {
+        // samples left from the last time the tap was armed are stale
+        ring.discard();
+        ++consumers;
+    }
+    void disarm()
+    {
+        jassert(consumers.load() > 0);
+        --consumers;
+    }
+
+    // audio thread: a single bulk copy into the ring
     void update(const BlockType& buffer)
     {
         jassert(prepared.get());
-        jassert(buffer.getNumChannels() > channelToUse);
-        auto* channelPtr = buffer.getReadPointer(channelToUse);
-
-        for (int i = 0; i < buffer.getNumSamples(); ++i)
-        {
-            pushNextSampleIntoFifo(channelPtr[i]);
-        }
+        jassert(buffer.getNumChannels() > 0);
+        // a mono signal feeds both the left and the right tap
+        ring.push(buffer.getReadPointer(juce::jmin((int)channelToUse, buffer.getNumChannels() - 1)), buffer.getNumSamples());
     }
 
     void prepare(int bufferSize)
     {
         prepared.set(false);
         size.set(bufferSize);
-
-        bufferToFill.setSize(
-            1,             //channel
-            bufferSize,    //num samples
-            false,         //keepExistingContent
-            true,          //clear extra space
-            true);         //avoid reallocating
-        audioBufferFifo.prepare(1, bufferSize);
-        fifoIndex = 0;
+        // room for the same amount of blocks of the old per-block FIFO
+        ring.prepare(bufferSize * Capacity);
         prepared.set(true);
     }
     //==============================================================================
-    int getNumCompleteBuffersAvailable() const { return audioBufferFifo.getNumAvailableForReading(); }
+    int getNumCompleteBuffersAvailable() const { return size.get() > 0 ? ring.getNumReady() / size.get() : 0; }
     bool isPrepared() const { return prepared.get(); }
     int getSize() const { return size.get(); }
     //==============================================================================
-    bool getAudioBuffer(BlockType& buf) { return audioBufferFifo.pull(buf); }
+    // GUI thread: reads one block of getSize() samples
+    bool getAudioBuffer(BlockType& buf)
+    {
+        if (buf.getNumSamples() != size.get())
+            buf.setSize(1, size.get(), false, false, true);
+        return ring.pull(buf.getWritePointer(0), size.get());
+    }
+    bool getSamples(float* dest, int numSamples) { return ring.pull(dest, numSamples); }
 private:
+    static constexpr int Capacity = 30;
     Channel channelToUse;
-    int fifoIndex = 0;
-    Fifo<BlockType> audioBufferFifo;
-    BlockType bufferToFill;
+    SampleRing ring;
     juce::Atomic<bool> prepared = false;
     juce::Atomic<int> size = 0;
-
-    void pushNextSampleIntoFifo(float sample)
-    {
-        if (fifoIndex == bufferToFill.getNumSamples())
-        {
-            auto ok = audioBufferFifo.push(bufferToFill);
-
-            juce::ignoreUnused(ok);
-
-            fifoIndex = 0;
-        }
-
-        bufferToFill.setSample(0, fifoIndex, sample);
-        ++fifoIndex;
-    }
+    std::atomic<int> consumers{ 0 };
 };
 
 enum FFTOrder
@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    NoiseGenerator.cpp
+
+    Copyright (c) 2021 KillBizz - Gabriel Bizzo
+
+  ==============================================================================
+*/
+
+/*
+
+This file is part of Biztortion software.
+
+Biztortion is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Biztortion is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Biztortion. If not, see < http://www.gnu.org/licenses/>.
+
+*/
+
+#include "NoiseGenerator.h"
+
+//==============================================================================
+
+/* GaussianNoiseGenerator */
+
+//==============================================================================
+
+GaussianNoiseGenerator::GaussianNoiseGenerator()
+{
+    setSeed(0);
+}
+
+void GaussianNoiseGenerator::setSeed(juce::uint64 seed) noexcept
+{
+    // splitmix64 spreads the seed over the lanes (xorshift needs non-zero states)
+    for (auto& lane : state) {
+        seed += 0x9E3779B97F4A7C15ull;
+        auto z = seed;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z ^= z >> 31;
+        lane = static_cast<juce::uint32>(z) | 1u;
+    }
+}
+
+void GaussianNoiseGenerator::generateChunk(float* chunk) noexcept
+{
+    // sum of numUniforms U(0, 1) has mean numUniforms / 2 and variance numUniforms / 12
+    constexpr float uniformScale = 1.f / 16777216.f;
+    const float gaussianScale = std::sqrt(12.f / numUniforms);
+
+    float sum[numLanes] = {};
+    for (int u = 0; u < numUniforms; ++u) {
+        for (int lane = 0; lane < numLanes; ++lane) {
+            auto x = state[lane];
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            state[lane] = x;
+            // 24 bits -> exact float in [0, 1)
+            sum[lane] += static_cast<float>(x >> 8) * uniformScale;
+        }
+    }
+    for (int lane = 0; lane < numLanes; ++lane) {
+        chunk[lane] = (sum[lane] - numUniforms * 0.5f) * gaussianScale;
+    }
+}
+
+void GaussianNoiseGenerator::fill(float* destination, int numSamples) noexcept
+{
+    int i = 0;
+    for (; i + numLanes <= numSamples; i += numLanes) {
+        generateChunk(destination + i);
+    }
+    if (i < numSamples) {
+        float chunk[numLanes];
+        generateChunk(chunk);
+        for (int lane = 0; i < numSamples; ++i, ++lane) {
+            destination[i] = chunk[lane];
+        }
+    }
+}
@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    NoiseGenerator.h
+
+    Copyright (c) 2021 KillBizz - Gabriel Bizzo
+
+  ==============================================================================
+*/
+
+/*
+
+This file is part of Biztortion software.
+
+Biztortion is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Biztortion is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Biztortion. If not, see < http://www.gnu.org/licenses/>.
+
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+//==============================================================================
+
+/* GaussianNoiseGenerator */
+
+//==============================================================================
+
+/**
+* Realtime-safe gaussian white noise: a few independent xorshift32 lanes, so that the
+* generation loops can be vectorized, and a sum-of-uniforms (Irwin-Hall) approximation
+* of the gaussian distribution (mean 0, variance 1, range -3.46/+3.46).
+* Use one generator per channel, seeded with different values, to get decorrelated streams.
+*/
+class GaussianNoiseGenerator {
+public:
+    GaussianNoiseGenerator();
+
+    // same seed => same sequence of samples
+    void setSeed(juce::uint64 seed) noexcept;
+    // writes numSamples gaussian samples in destination (no allocation, no locks)
+    void fill(float* destination, int numSamples) noexcept;
+
+private:
+    void generateChunk(float* chunk) noexcept;
+
+    static constexpr int numLanes = 8;
+    // uniforms summed for every gaussian sample
+    static constexpr int numUniforms = 4;
+
+    std::array<juce::uint32, numLanes> state;
+};
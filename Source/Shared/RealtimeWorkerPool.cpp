@@ -0,0 +1,196 @@
+/*
+  ==============================================================================
+
+    RealtimeWorkerPool.cpp
+
+    Copyright (c) 2021 KillBizz - Gabriel Bizzo
+
+  ==============================================================================
+*/
+
+/*
+
+This file is part of Biztortion software.
+
+Biztortion is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Biztortion is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Biztortion. If not, see < http://www.gnu.org/licenses/>.
+
+*/
+#include "RealtimeWorkerPool.h"
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+namespace {
+    // time a worker spins after its last job before going to sleep: long enough for the next sub-block of
+    // the same processBlock, short enough not to keep the cores busy between host callbacks. A pause lasts
+    // from about 10 to about 140 cycles depending on the CPU, so the budget is measured instead of counted
+    constexpr double spinSeconds = 0.0001;
+    // pauses between two reads of the clock
+    constexpr int pausesPerClockCheck = 32;
+
+    inline juce::uint32 getGeneration(juce::uint64 ticket) noexcept { return (juce::uint32)(ticket >> 32); }
+    inline int getNumLanes(juce::uint64 ticket) noexcept { return (int)((ticket >> 16) & 0xffff); }
+    inline int getNextLane(juce::uint64 ticket) noexcept { return (int)(ticket & 0xffff); }
+
+    inline void pause() noexcept
+    {
+#if JUCE_INTEL
+        _mm_pause();
+#endif
+    }
+}
+
+//==============================================================================
+
+class RealtimeWorkerPool::Worker : public juce::Thread {
+public:
+    Worker(RealtimeWorkerPool& p, int index)
+        : juce::Thread("Biztortion worker " + juce::String(index)), pool(p)
+    {
+        // the audio thread is usually on the first core
+        setAffinityMask((juce::uint32)1 << ((index + 1) % 32));
+        startThread(juce::Thread::realtimeAudioPriority);
+    }
+
+    ~Worker() override
+    {
+        signalThreadShouldExit();
+        wakeUp.signal();
+        stopThread(1000);
+    }
+
+    void run() override
+    {
+        // the lanes run audio code, like processBlock on the audio thread
+        juce::ScopedNoDenormals noDenormals;
+        juce::uint32 lastGeneration = 0;
+        while (!threadShouldExit()) {
+            bool worked = false;
+            const auto spinEnd = juce::Time::getHighResolutionTicks() + juce::Time::secondsToHighResolutionTicks(spinSeconds);
+            while (!worked && juce::Time::getHighResolutionTicks() < spinEnd) {
+                for (int i = 0; i < pausesPerClockCheck && !worked; ++i) {
+                    worked = pool.workOnce(lastGeneration);
+                    if (!worked)
+                        pause();
+                }
+            }
+            if (worked)
+                continue;
+
+            // nothing to do: sleep until the next job (the timeout only checks threadShouldExit).
+            // Dekker handshake with run(): numSleeping is raised before the ticket is read again and run() stores the
+            // ticket before reading numSleeping, all seq_cst, so either this read sees the job or run() signals the event
+            ++pool.numSleeping;
+            if (!pool.workOnce(lastGeneration))
+                wakeUp.wait(10);
+            --pool.numSleeping;
+        }
+    }
+
+    juce::WaitableEvent wakeUp;
+
+private:
+    RealtimeWorkerPool& pool;
+};
+
+//==============================================================================
+
+RealtimeWorkerPool::RealtimeWorkerPool()
+    : RealtimeWorkerPool(getDefaultNumWorkers())
+{
+}
+
+RealtimeWorkerPool::RealtimeWorkerPool(int numWorkers)
+{
+    for (int i = 0; i < numWorkers; ++i)
+        workers.push_back(std::make_unique<Worker>(*this, i));
+}
+
+RealtimeWorkerPool::~RealtimeWorkerPool()
+{
+    workers.clear();
+}
+
+int RealtimeWorkerPool::getDefaultNumWorkers()
+{
+    const auto numCpus = juce::SystemStats::getNumCpus();
+    return numCpus >= 4 ? juce::jlimit(0, 3, numCpus - 2) : 0;
+}
+
+void RealtimeWorkerPool::run(int numLanes, LaneFunction function, void* context) noexcept
+{
+    jassert(numLanes <= maxLanes);
+    if (numLanes <= 0)
+        return;
+
+    // nothing to share, or the workers are taken by the job this call is nested in: inline
+    if (numLanes == 1 || workers.empty() || busy.exchange(true, std::memory_order_acquire)) {
+        for (int lane = 0; lane < numLanes; ++lane)
+            function(context, lane);
+        return;
+    }
+
+    // the previous job is finished, so no worker reads these while they change
+    jobFunction = function;
+    jobContext = context;
+    completedLanes.store(0, std::memory_order_relaxed);
+    const auto newTicket = ((juce::uint64)++generation << 32) | ((juce::uint64)numLanes << 16);
+    ticket.store(newTicket, std::memory_order_seq_cst);
+
+    // only sleeping workers need the event, awake ones are spinning on the ticket. signal() locks the
+    // mutex of the event: the audio thread may wait there for a worker going to sleep at the same time
+    if (numSleeping.load(std::memory_order_seq_cst) > 0) {
+        for (auto& worker : workers)
+            worker->wakeUp.signal();
+    }
+
+    // the audio thread works too, and takes the lanes no worker has claimed yet
+    runLanes();
+    while (completedLanes.load(std::memory_order_acquire) < numLanes)
+        pause();
+
+    busy.store(false, std::memory_order_release);
+}
+
+bool RealtimeWorkerPool::claimLane(int& lane) noexcept
+{
+    // one ticket per claim, no retry. A worker late on an old job may land in a newer one: the lane is
+    // still a lane of that job, and the acquire makes its function and context visible
+    const auto claimed = ticket.fetch_add(1, std::memory_order_acq_rel);
+    lane = getNextLane(claimed);
+    return lane < getNumLanes(claimed);
+}
+
+void RealtimeWorkerPool::runLanes() noexcept
+{
+    int lane;
+    while (claimLane(lane)) {
+        // a claimed lane keeps its job alive, so function and context can't change until it is completed
+        jobFunction(jobContext, lane);
+        completedLanes.fetch_add(1, std::memory_order_release);
+    }
+}
+
+bool RealtimeWorkerPool::workOnce(juce::uint32& lastGeneration) noexcept
+{
+    // seq_cst for the sleep handshake (see Worker::run), the same instruction as an acquire load on x86 and ARMv8
+    const auto current = ticket.load(std::memory_order_seq_cst);
+    if (getGeneration(current) == lastGeneration)
+        return false;
+
+    lastGeneration = getGeneration(current);
+    runLanes();
+    return true;
+}
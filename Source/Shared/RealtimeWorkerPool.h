@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+    RealtimeWorkerPool.h
+
+    Copyright (c) 2021 KillBizz - Gabriel Bizzo
+
+  ==============================================================================
+*/
+
+/*
+
+This file is part of Biztortion software.
+
+Biztortion is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Biztortion is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Biztortion. If not, see < http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+
+/* RealtimeWorkerPool */
+
+//==============================================================================
+
+/**
+* Runs independent lanes of work (left/right channels, bands, parallel branches) concurrently
+* inside one processBlock. The audio thread runs lanes itself while the workers wake up, so a late
+* worker costs nothing but the parallelism, and it only waits for the lanes already claimed by a
+* worker. The workers are pinned to their own core, spin for a while after each job (consecutive
+* sub-blocks find them awake) and then sleep on an event.
+* Waking a sleeping worker signals a juce::WaitableEvent, which takes its mutex for a moment: the
+* audio thread can block briefly there (never while the workers are spinning).
+* The processor shares one pool between all the instances of the plugin (juce::SharedResourcePointer),
+* the default constructor sizes it for the machine.
+*/
+class RealtimeWorkerPool {
+public:
+    using LaneFunction = void (*)(void* context, int lane);
+
+    RealtimeWorkerPool();
+    explicit RealtimeWorkerPool(int numWorkers);
+    ~RealtimeWorkerPool();
+
+    // leaves a core to the host and one to the audio thread, no workers on machines with less than 4 cores
+    static int getDefaultNumWorkers();
+
+    int getNumWorkers() const noexcept { return (int)workers.size(); }
+
+    /**
+    * Audio thread: calls function(context, lane) for every lane in [0, numLanes) and returns
+    * when all of them are finished. No allocation. Each lane is claimed with one atomic fetch-and-add,
+    * the only lock is the one of the wake-up events, taken when some workers are asleep.
+    * A call made while another job is running (from one of its lanes, or from a second thread)
+    * runs its lanes inline, so a module using the pool can itself run in a lane.
+    *
+    * @param    numLanes the number of independent lanes, at most maxLanes
+    * @param    function the work of one lane, it must not touch the data of the other lanes
+    * @param    context the data shared by the lanes, it must outlive the call
+    */
+    void run(int numLanes, LaneFunction function, void* context) noexcept;
+
+    // below 0x8000, so that the extra fetch-and-adds of the claims of an exhausted job (one per
+    // thread at most) can never carry into the lane count
+    static constexpr int maxLanes = 0x7fff;
+
+private:
+    class Worker;
+
+    // claims the next lane of the current job, false when it has no lanes left
+    bool claimLane(int& lane) noexcept;
+    void runLanes() noexcept;
+    // worker side: processes the published job, if any. Returns false when there is nothing new
+    bool workOnce(juce::uint32& lastGeneration) noexcept;
+
+    // the job: generation (32 bit) | numLanes (16 bit) | next lane (16 bit). The workers only
+    // look at the generation to notice a new job, a claim is valid for whatever job it lands in
+    std::atomic<juce::uint64> ticket{ 0 };
+    std::atomic<int> completedLanes{ 0 };
+    LaneFunction jobFunction = nullptr;
+    void* jobContext = nullptr;
+    juce::uint32 generation = 0;
+
+    // set while a job is running, the nested calls run inline
+    std::atomic<bool> busy{ false };
+    std::atomic<int> numSleeping{ 0 };
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    JUCE_DECLARE_NON_COPYABLE(RealtimeWorkerPool)
+};
@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    ScratchArena.cpp
+
+    Copyright (c) 2021 KillBizz - Gabriel Bizzo
+
+  ==============================================================================
+*/
+
+/*
+
+This file is part of Biztortion software.
+
+Biztortion is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Biztortion is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Biztortion. If not, see < http://www.gnu.org/licenses/>.
+
+*/
+#include "ScratchArena.h"
+
+void ScratchArena::prepare(int newNumChannels, int newMaxBlockSize)
+{
+    numChannels = juce::jmax(1, newNumChannels);
+    maxBlockSize = juce::jmax(1, newMaxBlockSize);
+    channelStride = (maxBlockSize + alignment - 1) / alignment * alignment;
+
+    // extra room to move the start on a 64 byte boundary
+    memory.assign(((size_t)numSlots * (size_t)numChannels + (size_t)maxRamps) * (size_t)channelStride + alignment, 0.f);
+    auto address = reinterpret_cast<std::uintptr_t>(memory.data());
+    auto offset = (64 - address % 64) % 64 / sizeof(float);
+    alignedData = memory.data() + offset;
+}
+
+juce::AudioBuffer<float> ScratchArena::getBuffer(Slot slot, int numSamples) noexcept
+{
+    jassert(numSamples <= maxBlockSize);
+    // a JUCE AudioBuffer keeps up to 32 channel pointers without allocating
+    float* channels[32];
+    jassert(numChannels <= 32);
+    for (int channel = 0; channel < juce::jmin(numChannels, 32); ++channel)
+        channels[channel] = getChannel(slot, channel);
+    return juce::AudioBuffer<float>(channels, juce::jmin(numChannels, 32), juce::jmin(numSamples, maxBlockSize));
+}
+
+float* ScratchArena::getChannel(Slot slot, int channel) noexcept
+{
+    jassert(alignedData != nullptr && channel < numChannels);
+    return alignedData + ((size_t)slot * (size_t)numChannels + (size_t)channel) * (size_t)channelStride;
+}
+
+float* ScratchArena::getRamp(int index) noexcept
+{
+    // the ramps follow the channels of the slots
+    jassert(alignedData != nullptr && index >= 0 && index < maxRamps);
+    return alignedData + ((size_t)numSlots * (size_t)numChannels + (size_t)index) * (size_t)channelStride;
+}
@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    ScratchArena.h
+
+    Copyright (c) 2021 KillBizz - Gabriel Bizzo
+
+  ==============================================================================
+*/
+
+/*
+
+This file is part of Biztortion software.
+
+Biztortion is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Biztortion is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Biztortion. If not, see < http://www.gnu.org/licenses/>.
+
+*/
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+//==============================================================================
+
+/* ScratchArena */
+
+//==============================================================================
+
+/**
+* Temporary audio buffers shared by all the modules of the chain, owned by the processor.
+* The modules process one after another, so they can all borrow the same few buffers:
+* the memory is allocated once in prepare() (never on the audio thread) and stays hot in cache.
+* Every channel starts on a 64 byte boundary.
+*/
+class ScratchArena {
+public:
+    // the buffers a module can borrow at the same time
+    enum Slot {
+        Wet,
+        Temp,
+        Noise,
+        numSlots
+    };
+
+    ScratchArena() = default;
+
+    // not thread safe: call it only while the audio thread is not processing
+    void prepare(int numChannels, int maxBlockSize);
+
+    /**
+    * Borrows a slot: the returned buffer refers to the arena memory (no allocation) and
+    * is valid until the next prepare(). The content is whatever the last borrower left.
+    *
+    * @param    slot the buffer to borrow
+    * @param    numSamples the number of samples per channel, at most getMaxBlockSize()
+    */
+    juce::AudioBuffer<float> getBuffer(Slot slot, int numSamples) noexcept;
+    float* getChannel(Slot slot, int channel) noexcept;
+
+    // per sample values of the smoothed parameters of a module: computed once, read by every channel
+    static constexpr int maxRamps = 12;
+    // getMaxBlockSize() floats, the content is whatever the last borrower left
+    float* getRamp(int index) noexcept;
+
+    int getNumChannels() const noexcept { return numChannels; }
+    int getMaxBlockSize() const noexcept { return maxBlockSize; }
+
+private:
+    static constexpr int alignment = 64 / sizeof(float);
+
+    std::vector<float> memory;
+    float* alignedData = nullptr;
+    // floats from a channel to the next one (a multiple of the alignment)
+    int channelStride = 0;
+    int numChannels = 0;
+    int maxBlockSize = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(ScratchArena)
+};
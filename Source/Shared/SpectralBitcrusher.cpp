@@ -0,0 +1,220 @@
+/*
+  ==============================================================================
+
+    SpectralBitcrusher.cpp
+
+    Copyright (c) 2021 KillBizz - Gabriel Bizzo
+
+  ==============================================================================
+*/
+
+/*
+
+This file is part of Biztortion software.
+
+Biztortion is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Biztortion is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Biztortion. If not, see < http://www.gnu.org/licenses/>.
+
+*/
+
+#include "SpectralBitcrusher.h"
+
+//==============================================================================
+
+/* SpectralBitcrusher */
+
+//==============================================================================
+
+SpectralBitcrusher::SpectralBitcrusher()
+{
+    for (int i = 0; i < (int)ffts.size(); ++i) {
+        ffts[i] = std::make_unique<juce::dsp::FFT>(minOrder + i);
+    }
+
+    const int maxSize = 1 << maxOrder;
+    window.allocate(maxSize, false);
+    for (int i = 0; i < maxSize; ++i) {
+        window[i] = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * i / maxSize);
+    }
+}
+
+void SpectralBitcrusher::prepare(int channels)
+{
+    numChannels = channels;
+    const int maxSize = 1 << maxOrder;
+    inputRings.setSize(numChannels, maxSize);
+    // the real-only FFT works on 2 * size floats
+    frames.setSize(numChannels, 2 * maxSize);
+    outputRings.setSize(numChannels, 2 * maxSize);
+    setOrder(order);
+}
+
+void SpectralBitcrusher::setOrder(int newOrder) noexcept
+{
+    order = juce::jlimit(minOrder, maxOrder, newOrder);
+    fftSize = 1 << order;
+    hopSize = fftSize / 4;
+    windowStride = 1 << (maxOrder - order);
+    reset();
+}
+
+int SpectralBitcrusher::getOrder() const noexcept
+{
+    return order;
+}
+
+void SpectralBitcrusher::reset() noexcept
+{
+    inputRings.clear();
+    frames.clear();
+    outputRings.clear();
+    time = 0;
+    frameStart = 0;
+    hopPosition = 0;
+}
+
+int SpectralBitcrusher::getLatencySamples(int fftOrder) noexcept
+{
+    const int size = 1 << fftOrder;
+    return size + size / 4;
+}
+
+int SpectralBitcrusher::getLatencySamples() const noexcept
+{
+    return getLatencySamples(order);
+}
+
+void SpectralBitcrusher::process(juce::AudioBuffer<float>& buffer, int numSamples, float bitDepth, float binHoldRatio) noexcept
+{
+    // a mid only / side only slot passes a single lane
+    activeChannels = juce::jmin(buffer.getNumChannels(), numChannels);
+
+    currentBitDepth = bitDepth;
+    currentBinHoldRatio = juce::jmax(1.f, binHoldRatio);
+
+    const juce::uint32 inputMask = (juce::uint32)fftSize - 1;
+    const juce::uint32 outputMask = 2 * (juce::uint32)fftSize - 1;
+    const juce::uint32 latency = (juce::uint32)getLatencySamples();
+    const int stageLength = hopSize / 4;
+
+    for (int i = 0; i < numSamples; ++i) {
+        for (int channel = 0; channel < activeChannels; ++channel) {
+            inputRings.getWritePointer(channel)[time & inputMask] = buffer.getReadPointer(channel)[i];
+        }
+
+        // one stage of the frame every quarter of hop
+        if (hopPosition == 0) {
+            frameStart = time - inputMask;
+            captureFrames();
+        }
+        else if (hopPosition == stageLength) {
+            forwardTransforms();
+        }
+        else if (hopPosition == 2 * stageLength) {
+            crushSpectra();
+        }
+        else if (hopPosition == 3 * stageLength) {
+            inverseTransformsAndOverlapAdd();
+        }
+        if (++hopPosition == hopSize) {
+            hopPosition = 0;
+        }
+
+        const auto readIndex = (time - latency) & outputMask;
+        for (int channel = 0; channel < activeChannels; ++channel) {
+            auto* output = outputRings.getWritePointer(channel);
+            buffer.getWritePointer(channel)[i] = output[readIndex];
+            output[readIndex] = 0.f;
+        }
+        ++time;
+    }
+}
+
+void SpectralBitcrusher::captureFrames() noexcept
+{
+    const juce::uint32 inputMask = (juce::uint32)fftSize - 1;
+    for (int channel = 0; channel < activeChannels; ++channel) {
+        auto* input = inputRings.getReadPointer(channel);
+        auto* frame = frames.getWritePointer(channel);
+        // the oldest sample of the ring is the first of the frame
+        for (int n = 0; n < fftSize; ++n) {
+            frame[n] = input[(frameStart + (juce::uint32)n) & inputMask] * window[n * windowStride];
+        }
+        juce::FloatVectorOperations::clear(frame + fftSize, fftSize);
+    }
+}
+
+void SpectralBitcrusher::forwardTransforms() noexcept
+{
+    auto& fft = *ffts[order - minOrder];
+    for (int channel = 0; channel < activeChannels; ++channel) {
+        fft.performRealOnlyForwardTransform(frames.getWritePointer(channel), true);
+    }
+}
+
+void SpectralBitcrusher::crushSpectra() noexcept
+{
+    // a full scale sine gives a magnitude of fftSize / 4 through the Hann window
+    const float magnitudeScale = 4.f / fftSize;
+    const float magnitudeStep = std::exp2(-currentBitDepth);
+    const float phaseStep = juce::MathConstants<float>::twoPi * magnitudeStep;
+    const float binHoldIncrement = 1.f / currentBinHoldRatio;
+    const int numBins = fftSize / 2 + 1;
+
+    for (int channel = 0; channel < activeChannels; ++channel) {
+        auto* bins = frames.getWritePointer(channel);
+        float holdPhase = 1.f;
+        float heldReal = 0.f, heldImag = 0.f;
+
+        for (int bin = 0; bin < numBins; ++bin) {
+            auto& real = bins[2 * bin];
+            auto& imag = bins[2 * bin + 1];
+
+            // sample and hold over the bins
+            holdPhase += binHoldIncrement;
+            if (holdPhase >= 1.f) {
+                holdPhase -= std::floor(holdPhase);
+
+                // magnitude truncated as in the time-domain quantizer, phase rounded
+                auto magnitude = std::sqrt(real * real + imag * imag) * magnitudeScale;
+                magnitude = magnitudeStep * std::trunc(magnitude / magnitudeStep) / magnitudeScale;
+                auto phase = phaseStep * std::round(std::atan2(imag, real) / phaseStep);
+                heldReal = magnitude * std::cos(phase);
+                heldImag = magnitude * std::sin(phase);
+            }
+            real = heldReal;
+            imag = heldImag;
+        }
+        // DC and Nyquist bins are real
+        bins[1] = 0.f;
+        bins[2 * (numBins - 1) + 1] = 0.f;
+    }
+}
+
+void SpectralBitcrusher::inverseTransformsAndOverlapAdd() noexcept
+{
+    auto& fft = *ffts[order - minOrder];
+    const juce::uint32 outputMask = 2 * (juce::uint32)fftSize - 1;
+    // the squared Hann windows at 75% overlap sum to 1.5
+    const float overlapGain = 2.f / 3.f;
+
+    for (int channel = 0; channel < activeChannels; ++channel) {
+        auto* frame = frames.getWritePointer(channel);
+        fft.performRealOnlyInverseTransform(frame);
+
+        auto* output = outputRings.getWritePointer(channel);
+        for (int n = 0; n < fftSize; ++n) {
+            output[(frameStart + (juce::uint32)n) & outputMask] += frame[n] * window[n * windowStride] * overlapGain;
+        }
+    }
+}
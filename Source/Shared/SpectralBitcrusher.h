@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    SpectralBitcrusher.h
+
+    Copyright (c) 2021 KillBizz - Gabriel Bizzo
+
+  ==============================================================================
+*/
+
+/*
+
+This file is part of Biztortion software.
+
+Biztortion is free software : you can redistribute it and /or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Biztortion is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Biztortion. If not, see < http://www.gnu.org/licenses/>.
+
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <memory>
+
+//==============================================================================
+
+/* SpectralBitcrusher */
+
+//==============================================================================
+
+/**
+* Streaming STFT bitcrusher: Hann windowed frames with 75% overlap-add, where the bit depth
+* quantizes magnitude and phase of every bin and the rate holds bins like a sample and hold
+* over the spectrum.
+* 
+* The FFTs of every order are allocated in advance, so the order can be switched on the audio thread.
+* The work of a frame is split in 4 stages (windowing, forward FFT, quantization, inverse FFT + overlap-add)
+* spread over the hop, so no block pays for a whole frame.
+*/
+class SpectralBitcrusher {
+public:
+    static const int minOrder = 10;
+    static const int maxOrder = 12;
+
+    SpectralBitcrusher();
+
+    // message thread: allocates the buffers for the biggest FFT order
+    void prepare(int numChannels);
+    // no allocation: selects one of the preallocated FFTs and clears the state
+    void setOrder(int newOrder) noexcept;
+    int getOrder() const noexcept;
+    void reset() noexcept;
+
+    // FFT size plus one hop, which gives the staged processing the time to complete a frame
+    static int getLatencySamples(int order) noexcept;
+    int getLatencySamples() const noexcept;
+
+    /**
+    * Processes the signal in place, the output is delayed by getLatencySamples()
+    * 
+    * @param    buffer the signal, its first channels (at most the prepared ones) are processed
+    * @param    numSamples the number of samples to process
+    * @param    bitDepth quantization resolution of magnitude and phase (1 - 16)
+    * @param    binHoldRatio number of bins held by each captured bin (sampleRate / rate, >= 1)
+    */
+    void process(juce::AudioBuffer<float>& buffer, int numSamples, float bitDepth, float binHoldRatio) noexcept;
+
+private:
+    void captureFrames() noexcept;
+    void forwardTransforms() noexcept;
+    void crushSpectra() noexcept;
+    void inverseTransformsAndOverlapAdd() noexcept;
+
+    std::array<std::unique_ptr<juce::dsp::FFT>, maxOrder - minOrder + 1> ffts;
+    // periodic Hann window of the biggest size, smaller sizes read it with a stride
+    juce::HeapBlock<float> window;
+    juce::AudioBuffer<float> inputRings, frames, outputRings;
+    int numChannels = 0;
+    // channels of the buffer being processed, the others are not touched
+    int activeChannels = 0;
+
+    int order = minOrder, fftSize = 1 << minOrder, hopSize = (1 << minOrder) / 4, windowStride = 1 << (maxOrder - minOrder);
+    // wrapping sample counter, the rings are indexed with masks
+    juce::uint32 time = 0, frameStart = 0;
+    int hopPosition = 0;
+    float currentBitDepth = 16.f, currentBinHoldRatio = 1.f;
+};